@@ -0,0 +1,357 @@
+// Name: Kevin Fang
+// Connected components labeling of binary images.
+// Masks and label images are stored row-major in flat vectors so
+// that the labeling loops don't go through Image's bounds checks.
+
+#include "connected_components.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+#include "DisjSets.h"
+
+namespace ComputerVisionProjects {
+
+namespace {
+
+// A horizontal run of foreground pixels [start, end) in one row.
+struct Run {
+  int start;
+  int end;
+};
+
+// Returns the first column >= j of mask_row that is foreground, or cols.
+// Eight background pixels are skipped at a time.
+int SkipBackground(const unsigned char *mask_row, int j, int cols) {
+  while (j + 8 <= cols) {
+    uint64_t word;
+    memcpy(&word, mask_row + j, sizeof word);
+    if (word != 0) break;
+    j += 8;
+  }
+  while (j < cols && !mask_row[j]) ++j;
+  return j;
+}
+
+// Splits every row of mask into runs. Runs of row i are
+// runs[row_start[i]] .. runs[row_start[i + 1] - 1].
+void ExtractRuns(const std::vector<unsigned char> &mask, int rows, int cols,
+                 std::vector<Run> *runs, std::vector<int> *row_start) {
+  runs->clear();
+  row_start->assign(rows + 1, 0);
+  for (int i = 0; i < rows; ++i) {
+    (*row_start)[i] = runs->size();
+    const unsigned char *mask_row = &mask[i * cols];
+    int j = SkipBackground(mask_row, 0, cols);
+    while (j < cols) {
+      const int start = j;
+      while (j < cols && mask_row[j]) ++j;
+      runs->push_back({start, j});
+      j = SkipBackground(mask_row, j, cols);
+    }
+  }
+  (*row_start)[rows] = runs->size();
+}
+
+// Union-find over provisional labels that several threads may update
+// at once. Roots are only ever linked under smaller roots, so the root
+// of a set is always its smallest label.
+class ConcurrentEquivalences {
+ public:
+  explicit ConcurrentEquivalences(size_t num_labels) : parent_(num_labels) { }
+
+  // Must be called (by the owning thread) before label is used.
+  void MakeSet(int label) { parent_[label].store(label, std::memory_order_relaxed); }
+
+  // Find with path halving; the halving CAS may fail harmlessly.
+  int Find(int label) {
+    int parent = parent_[label].load(std::memory_order_acquire);
+    while (parent != label) {
+      const int grandparent = parent_[parent].load(std::memory_order_acquire);
+      parent_[label].compare_exchange_weak(parent, grandparent, std::memory_order_acq_rel);
+      label = grandparent;
+      parent = parent_[label].load(std::memory_order_acquire);
+    }
+    return label;
+  }
+
+  void Union(int label1, int label2) {
+    while (true) {
+      int root1 = Find(label1);
+      int root2 = Find(label2);
+      if (root1 == root2) return;
+      if (root1 < root2) std::swap(root1, root2);
+      // Link the larger root under the smaller one, unless another
+      // thread re-parented it first; then retry from the new roots.
+      int expected = root1;
+      if (parent_[root1].compare_exchange_strong(expected, root2, std::memory_order_acq_rel))
+        return;
+      label1 = root1;
+      label2 = root2;
+    }
+  }
+
+ private:
+  std::vector<std::atomic<int>> parent_;
+};
+
+// Runs body(strip) for strip = 0 .. num_strips - 1, one thread each.
+template <typename Body>
+void ForEachStrip(int num_strips, Body body) {
+  std::vector<std::thread> threads;
+  for (int strip = 1; strip < num_strips; ++strip) threads.emplace_back(body, strip);
+  body(0);
+  for (std::thread &thread : threads) thread.join();
+}
+
+}  // namespace
+
+void ImageToMask(const Image &binary_image, std::vector<unsigned char> *mask) {
+  if (mask == nullptr) abort();
+  const size_t rows = binary_image.num_rows();
+  const size_t cols = binary_image.num_columns();
+  mask->resize(rows * cols);
+  for (size_t i = 0; i < rows; ++i)
+    for (size_t j = 0; j < cols; ++j)
+      (*mask)[i * cols + j] = binary_image.GetPixel(i, j) != 0;
+}
+
+void LabelsToImage(const std::vector<int> &labels, size_t num_rows,
+                   size_t num_columns, Image *labeled_image) {
+  if (labeled_image == nullptr) abort();
+  labeled_image->AllocateSpaceAndSetSize(num_rows, num_columns);
+  labeled_image->SetNumberGrayLevels(255);
+  for (size_t i = 0; i < num_rows; ++i)
+    for (size_t j = 0; j < num_columns; ++j)
+      labeled_image->SetPixel(i, j, labels[i * num_columns + j]);
+}
+
+int LabelComponents(const std::vector<unsigned char> &mask, size_t num_rows,
+                    size_t num_columns, Connectivity connectivity,
+                    std::vector<int> *labels) {
+  if (labels == nullptr) abort();
+  const int rows = num_rows;
+  const int cols = num_columns;
+  labels->assign(num_rows * num_columns, 0);
+  int *label = labels->data();
+
+  // A new provisional label is only created for a pixel without labeled
+  // neighbors, so there can be at most one per two pixels (plus label 0).
+  DisjSets equivalences(rows * cols / 2 + 2);
+  int next_label = 1;
+  auto merge = [&equivalences](int label1, int label2) {
+    const int root1 = equivalences.find(label1);
+    const int root2 = equivalences.find(label2);
+    if (root1 != root2) equivalences.unionSets(root1, root2);
+  };
+
+  // First pass: provisional labels and their equivalences.
+  for (int i = 0; i < rows; ++i) {
+    const unsigned char *mask_row = &mask[i * cols];
+    int *row = label + i * cols;
+    const int *above = (i > 0) ? row - cols : nullptr;
+    for (int j = 0; j < cols; ++j) {
+      if (!mask_row[j]) continue;
+
+      int current = (j > 0) ? row[j - 1] : 0;
+      auto visit = [&](int neighbor) {
+        if (neighbor == 0) return;
+        if (current == 0) current = neighbor;
+        else if (neighbor != current) merge(current, neighbor);
+      };
+      if (above != nullptr) {
+        visit(above[j]);
+        if (connectivity == Connectivity::kEight) {
+          if (j > 0) visit(above[j - 1]);
+          if (j + 1 < cols) visit(above[j + 1]);
+        }
+      }
+      row[j] = (current != 0) ? current : next_label++;
+    }
+  }
+
+  // Provisional labels are created in raster order, so visiting them in
+  // increasing order numbers the objects by their first pixel.
+  std::vector<int> final_label(next_label, 0);
+  int num_objects = 0;
+  for (int provisional = 1; provisional < next_label; ++provisional) {
+    const int root = equivalences.find(provisional);
+    if (final_label[root] == 0) final_label[root] = ++num_objects;
+    final_label[provisional] = final_label[root];
+  }
+
+  // Second pass: replace provisional labels with the final ones.
+  for (size_t k = 0; k < labels->size(); ++k) label[k] = final_label[label[k]];
+  return num_objects;
+}
+
+int LabelComponentsRuns(const std::vector<unsigned char> &mask, size_t num_rows,
+                        size_t num_columns, Connectivity connectivity,
+                        std::vector<int> *labels) {
+  if (labels == nullptr) abort();
+  const int rows = num_rows;
+  const int cols = num_columns;
+
+  std::vector<Run> runs;
+  std::vector<int> row_start;
+  ExtractRuns(mask, rows, cols, &runs, &row_start);
+
+  // Run k has provisional label k + 1. With 8-connectivity runs that
+  // only touch diagonally overlap as well.
+  const int reach = (connectivity == Connectivity::kEight) ? 1 : 0;
+  DisjSets equivalences(runs.size() + 1);
+  for (int i = 1; i < rows; ++i) {
+    int previous = row_start[i - 1];
+    const int previous_end = row_start[i];
+    for (int current = row_start[i]; current < row_start[i + 1]; ++current) {
+      const Run &run = runs[current];
+      // Skip runs of the previous row that end before this one starts.
+      while (previous < previous_end && runs[previous].end + reach <= run.start) ++previous;
+      for (int k = previous; k < previous_end && runs[k].start < run.end + reach; ++k) {
+        const int root1 = equivalences.find(k + 1);
+        const int root2 = equivalences.find(current + 1);
+        if (root1 != root2) equivalences.unionSets(root1, root2);
+      }
+    }
+  }
+
+  // Runs are in raster order, so this numbers objects by their first pixel.
+  std::vector<int> final_label(runs.size() + 1, 0);
+  int num_objects = 0;
+  for (size_t provisional = 1; provisional <= runs.size(); ++provisional) {
+    const int root = equivalences.find(provisional);
+    if (final_label[root] == 0) final_label[root] = ++num_objects;
+    final_label[provisional] = final_label[root];
+  }
+
+  labels->assign(num_rows * num_columns, 0);
+  int *label = labels->data();
+  for (int i = 0; i < rows; ++i) {
+    for (int k = row_start[i]; k < row_start[i + 1]; ++k) {
+      int *row = label + i * cols;
+      const int value = final_label[k + 1];
+      for (int j = runs[k].start; j < runs[k].end; ++j) row[j] = value;
+    }
+  }
+  return num_objects;
+}
+
+int LabelComponentsParallel(const std::vector<unsigned char> &mask, size_t num_rows,
+                            size_t num_columns, Connectivity connectivity,
+                            int num_threads, std::vector<int> *labels) {
+  if (labels == nullptr) abort();
+  const int rows = num_rows;
+  const int cols = num_columns;
+  labels->assign(num_rows * num_columns, 0);
+  if (rows == 0 || cols == 0) return 0;
+  int *label = labels->data();
+
+  if (num_threads <= 0) num_threads = std::max(1u, std::thread::hardware_concurrency());
+  const int num_strips = std::min(num_threads, rows);
+  std::vector<int> strip_start(num_strips + 1);
+  for (int strip = 0; strip <= num_strips; ++strip)
+    strip_start[strip] = static_cast<long long>(rows) * strip / num_strips;
+
+  // A row can start at most (cols + 1) / 2 new labels, so strip k owns
+  // the labels from 1 + strip_start[k] * labels_per_row on.
+  const int labels_per_row = (cols + 1) / 2;
+  const size_t num_labels = 1 + static_cast<size_t>(rows) * labels_per_row;
+  ConcurrentEquivalences equivalences(num_labels);
+  std::vector<int> strip_end_label(num_strips);
+
+  const bool eight = (connectivity == Connectivity::kEight);
+
+  // Phase 1: every strip is labeled independently.
+  ForEachStrip(num_strips, [&](int strip) {
+    const int first_label = 1 + strip_start[strip] * labels_per_row;
+    int next_label = first_label;
+    for (int i = strip_start[strip]; i < strip_start[strip + 1]; ++i) {
+      const unsigned char *mask_row = &mask[i * cols];
+      int *row = label + i * cols;
+      const int *above = (i > strip_start[strip]) ? row - cols : nullptr;
+      for (int j = 0; j < cols; ++j) {
+        if (!mask_row[j]) continue;
+        int current = (j > 0) ? row[j - 1] : 0;
+        auto visit = [&](int neighbor) {
+          if (neighbor == 0) return;
+          if (current == 0) current = neighbor;
+          else if (neighbor != current) equivalences.Union(current, neighbor);
+        };
+        if (above != nullptr) {
+          visit(above[j]);
+          if (eight) {
+            if (j > 0) visit(above[j - 1]);
+            if (j + 1 < cols) visit(above[j + 1]);
+          }
+        }
+        if (current == 0) {
+          current = next_label++;
+          equivalences.MakeSet(current);
+        }
+        row[j] = current;
+      }
+    }
+    strip_end_label[strip] = next_label;
+  });
+
+  // Phase 2: the first row of every strip is merged with the last row
+  // of the strip above it.
+  ForEachStrip(num_strips, [&](int strip) {
+    if (strip == 0) return;
+    const int i = strip_start[strip];
+    const int *row = label + i * cols;
+    const int *above = row - cols;
+    for (int j = 0; j < cols; ++j) {
+      if (row[j] == 0) continue;
+      if (above[j] != 0) equivalences.Union(row[j], above[j]);
+      if (eight) {
+        if (j > 0 && above[j - 1] != 0) equivalences.Union(row[j], above[j - 1]);
+        if (j + 1 < cols && above[j + 1] != 0) equivalences.Union(row[j], above[j + 1]);
+      }
+    }
+  });
+
+  // Phase 3: roots are numbered per strip, offset by the number of roots
+  // in the strips above, which keeps the raster order.
+  std::vector<int> final_label(num_labels, 0);
+  std::vector<int> strip_roots(num_strips, 0);
+  ForEachStrip(num_strips, [&](int strip) {
+    for (int l = 1 + strip_start[strip] * labels_per_row; l < strip_end_label[strip]; ++l)
+      if (equivalences.Find(l) == l) final_label[l] = ++strip_roots[strip];
+  });
+  std::vector<int> strip_offset(num_strips, 0);
+  for (int strip = 1; strip < num_strips; ++strip)
+    strip_offset[strip] = strip_offset[strip - 1] + strip_roots[strip - 1];
+  const int num_objects = strip_offset[num_strips - 1] + strip_roots[num_strips - 1];
+
+  // Phase 4: every pixel gets the final label of its root.
+  ForEachStrip(num_strips, [&](int strip) {
+    const int first_label = 1 + strip_start[strip] * labels_per_row;
+    for (int l = first_label; l < strip_end_label[strip]; ++l)
+      if (final_label[l] != 0) final_label[l] += strip_offset[strip];
+  });
+  ForEachStrip(num_strips, [&](int strip) {
+    for (int k = strip_start[strip] * cols; k < strip_start[strip + 1] * cols; ++k)
+      if (label[k] != 0) label[k] = final_label[equivalences.Find(label[k])];
+  });
+  return num_objects;
+}
+
+int LabelComponents(const std::vector<unsigned char> &mask, size_t num_rows,
+                    size_t num_columns, Connectivity connectivity,
+                    LabelingMethod method, std::vector<int> *labels) {
+  switch (method) {
+    case LabelingMethod::kParallel:
+      return LabelComponentsParallel(mask, num_rows, num_columns, connectivity, 0, labels);
+    case LabelingMethod::kRuns:
+      return LabelComponentsRuns(mask, num_rows, num_columns, connectivity, labels);
+    case LabelingMethod::kTwoPass:
+    default:
+      return LabelComponents(mask, num_rows, num_columns, connectivity, labels);
+  }
+}
+
+}  // namespace ComputerVisionProjects
@@ -0,0 +1,70 @@
+// Name: Kevin Fang
+// Connected components labeling of binary images.
+// Masks and label images are stored row-major in flat vectors so
+// that the labeling loops don't go through Image's bounds checks.
+
+#ifndef COMPUTER_VISION_CONNECTED_COMPONENTS_H_
+#define COMPUTER_VISION_CONNECTED_COMPONENTS_H_
+
+#include <cstdlib>
+#include <vector>
+
+#include "image.h"
+
+namespace ComputerVisionProjects {
+
+// Which neighbors of a pixel belong to the same object.
+enum class Connectivity { kFour, kEight };
+
+// Labeling algorithm; every method produces exactly the same labels.
+enum class LabelingMethod {
+  kTwoPass,  // Pixel by pixel, LabelComponents().
+  kRuns,     // Run by run, LabelComponentsRuns().
+  kParallel, // Horizontal strips in parallel, LabelComponentsParallel().
+};
+
+// Copies binary_image into mask; every non-zero pixel is foreground (1).
+void ImageToMask(const Image &binary_image, std::vector<unsigned char> *mask);
+
+// Copies a flat label buffer into labeled_image. The number of gray
+// levels is set to 255, as p2 has always done.
+void LabelsToImage(const std::vector<int> &labels, size_t num_rows,
+                   size_t num_columns, Image *labeled_image);
+
+// Two-pass labeling with a flat union-find (DisjSets, union by rank and
+// path compression) over the provisional labels. Background pixels get
+// label 0 and objects are numbered 1..N without gaps, in the raster
+// order of their first pixel. Returns N.
+int LabelComponents(const std::vector<unsigned char> &mask, size_t num_rows,
+                    size_t num_columns, Connectivity connectivity,
+                    std::vector<int> *labels);
+
+// Same result as LabelComponents(), but the mask is first split into
+// horizontal runs of foreground pixels and the union-find works on
+// runs: a run is merged with the runs of the previous row that overlap
+// it. Background is skipped several pixels at a time and every object
+// pixel is written exactly once, which pays off on sparse masks.
+int LabelComponentsRuns(const std::vector<unsigned char> &mask, size_t num_rows,
+                        size_t num_columns, Connectivity connectivity,
+                        std::vector<int> *labels);
+
+// Same result as LabelComponents(), computed by num_threads threads
+// (0 means one per hardware thread). Each thread labels a horizontal
+// strip with its own range of provisional labels, then the labels that
+// touch across strip boundaries are merged in parallel with a lock-free
+// union-find that always links the larger root under the smaller one,
+// and finally every strip is relabeled in parallel. Because a set's root
+// is its smallest provisional label, the final numbering is the
+// canonical raster order of LabelComponents(), not the thread schedule.
+int LabelComponentsParallel(const std::vector<unsigned char> &mask, size_t num_rows,
+                            size_t num_columns, Connectivity connectivity,
+                            int num_threads, std::vector<int> *labels);
+
+// Dispatches to the labeling function of the given method.
+int LabelComponents(const std::vector<unsigned char> &mask, size_t num_rows,
+                    size_t num_columns, Connectivity connectivity,
+                    LabelingMethod method, std::vector<int> *labels);
+
+}  // namespace ComputerVisionProjects
+
+#endif  // COMPUTER_VISION_CONNECTED_COMPONENTS_H_
@@ -0,0 +1,195 @@
+// Name: Kevin Fang
+// Outer contours of the objects of a label image, traced pixel by
+// pixel along the boundary (Moore neighbor tracing) and stored as
+// Freeman chain codes, with perimeter-based shape features and a
+// polygon approximation.
+
+#include "contour.h"
+
+#include <cmath>
+
+using namespace std;
+
+namespace ComputerVisionProjects {
+
+const int kChainRowStep[8] = {0, -1, -1, -1, 0, 1, 1, 1};
+const int kChainColumnStep[8] = {1, 1, 0, -1, -1, -1, 0, 1};
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+
+// Distance from p to the line through a and b (to a when a == b).
+double DistanceToLine(const ContourPoint &p, const ContourPoint &a, const ContourPoint &b) {
+  const double dr = b.row - a.row;
+  const double dc = b.column - a.column;
+  const double length = sqrt(dr * dr + dc * dc);
+  if (length == 0) return hypot(p.row - a.row, p.column - a.column);
+  return fabs(dr * (p.column - a.column) - dc * (p.row - a.row)) / length;
+}
+
+// Marks the points of points[first..last] (last may be points.size(),
+// meaning points[0] again) that Ramer-Douglas-Peucker keeps.
+void Simplify(const vector<ContourPoint> &points, size_t first, size_t last,
+              double tolerance, vector<char> *keep) {
+  // An explicit stack, as long contours would recurse too deeply.
+  vector<pair<size_t, size_t>> ranges{{first, last}};
+  while (!ranges.empty()) {
+    const size_t begin = ranges.back().first;
+    const size_t end = ranges.back().second;
+    ranges.pop_back();
+    const ContourPoint &a = points[begin];
+    const ContourPoint &b = points[end % points.size()];
+
+    double farthest = -1;
+    size_t split = begin;
+    for (size_t k = begin + 1; k < end; ++k) {
+      const double distance = DistanceToLine(points[k], a, b);
+      if (distance > farthest) {
+        farthest = distance;
+        split = k;
+      }
+    }
+    if (farthest > tolerance) {
+      (*keep)[split] = 1;
+      ranges.emplace_back(begin, split);
+      ranges.emplace_back(split, end);
+    }
+  }
+}
+
+}  // namespace
+
+bool TraceContour(const vector<int> &labels, size_t num_rows, size_t num_columns,
+                  ContourPoint start, Contour *contour) {
+  if (contour == nullptr) abort();
+  const int rows = num_rows;
+  const int cols = num_columns;
+  if (start.row < 0 || start.row >= rows || start.column < 0 || start.column >= cols) return false;
+  const int label = labels[start.row * cols + start.column];
+  auto same = [&](int r, int c) {
+    return r >= 0 && r < rows && c >= 0 && c < cols && labels[r * cols + c] == label;
+  };
+  // The pixels before start in raster order (W, NW, N, NE) must not
+  // belong to the object.
+  if (label == 0 || same(start.row, start.column - 1) || same(start.row - 1, start.column - 1) ||
+      same(start.row - 1, start.column) || same(start.row - 1, start.column + 1)) {
+    return false;
+  }
+
+  *contour = Contour();
+  contour->label = label;
+  contour->start = start;
+
+  // Moore tracing: search the neighbors counterclockwise, starting next
+  // to the pixel we came from, and stop when the first move is about to
+  // be repeated from start (Jacob's criterion), so objects that pass
+  // through start more than once are still traced completely.
+  ContourPoint p = start;
+  ContourPoint second;
+  int direction = 7;
+  double straight = 0, diagonal = 0, twice_area = 0;
+  while (true) {
+    const int first_try = (direction % 2 == 0) ? (direction + 7) % 8 : (direction + 6) % 8;
+    int found = -1;
+    for (int k = 0; k < 8; ++k) {
+      const int d = (first_try + k) % 8;
+      if (same(p.row + kChainRowStep[d], p.column + kChainColumnStep[d])) {
+        found = d;
+        break;
+      }
+    }
+    if (found < 0) break;  // A single pixel.
+
+    ContourPoint next;
+    next.row = p.row + kChainRowStep[found];
+    next.column = p.column + kChainColumnStep[found];
+    if (!contour->chain.empty() && p.row == start.row && p.column == start.column &&
+        next.row == second.row && next.column == second.column) {
+      break;
+    }
+    if (contour->chain.empty()) second = next;
+
+    contour->chain.push_back(found);
+    if (found % 2 == 0) ++straight; else ++diagonal;
+    twice_area += static_cast<double>(p.column) * next.row - static_cast<double>(next.column) * p.row;
+    p = next;
+    direction = found;
+  }
+
+  contour->perimeter = straight + diagonal * sqrt(2.0);
+  contour->area = fabs(twice_area) / 2.0;
+  if (contour->area > 0)
+    contour->compactness = contour->perimeter * contour->perimeter / (4.0 * kPi * contour->area);
+  return true;
+}
+
+int TraceContours(const vector<int> &labels, size_t num_rows, size_t num_columns,
+                  vector<Contour> *contours) {
+  if (contours == nullptr) abort();
+  contours->clear();
+  vector<char> seen;
+  for (size_t i = 0; i < num_rows; ++i) {
+    const int *row = &labels[i * num_columns];
+    for (size_t j = 0; j < num_columns; ++j) {
+      const int label = row[j];
+      if (label <= 0) continue;
+      if (label >= static_cast<int>(seen.size())) seen.resize(label + 1, 0);
+      if (seen[label]) continue;
+      seen[label] = 1;
+
+      ContourPoint start;
+      start.row = i;
+      start.column = j;
+      contours->emplace_back();
+      TraceContour(labels, num_rows, num_columns, start, &contours->back());
+    }
+  }
+  return contours->size();
+}
+
+void ContourPoints(const Contour &contour, vector<ContourPoint> *points) {
+  if (points == nullptr) abort();
+  points->clear();
+  points->reserve(contour.chain.size() + 1);
+  ContourPoint p = contour.start;
+  points->push_back(p);
+  for (size_t k = 0; k + 1 < contour.chain.size(); ++k) {
+    p.row += kChainRowStep[contour.chain[k]];
+    p.column += kChainColumnStep[contour.chain[k]];
+    points->push_back(p);
+  }
+}
+
+void ApproximatePolygon(const Contour &contour, double tolerance,
+                        vector<ContourPoint> *polygon) {
+  if (polygon == nullptr) abort();
+  vector<ContourPoint> points;
+  ContourPoints(contour, &points);
+  if (points.size() <= 2) {
+    *polygon = points;
+    return;
+  }
+
+  // Split the closed contour at start and at the point farthest from
+  // it, then simplify both halves.
+  size_t farthest = 0;
+  double farthest_distance = -1;
+  for (size_t k = 1; k < points.size(); ++k) {
+    const double distance = hypot(points[k].row - points[0].row, points[k].column - points[0].column);
+    if (distance > farthest_distance) {
+      farthest_distance = distance;
+      farthest = k;
+    }
+  }
+  vector<char> keep(points.size(), 0);
+  keep[0] = keep[farthest] = 1;
+  Simplify(points, 0, farthest, tolerance, &keep);
+  Simplify(points, farthest, points.size(), tolerance, &keep);
+
+  polygon->clear();
+  for (size_t k = 0; k < points.size(); ++k)
+    if (keep[k]) polygon->push_back(points[k]);
+}
+
+}  // namespace ComputerVisionProjects
@@ -0,0 +1,71 @@
+// Name: Kevin Fang
+// Outer contours of the objects of a label image, traced pixel by
+// pixel along the boundary (Moore neighbor tracing) and stored as
+// Freeman chain codes, with perimeter-based shape features and a
+// polygon approximation.
+
+#ifndef COMPUTER_VISION_CONTOUR_H_
+#define COMPUTER_VISION_CONTOUR_H_
+
+#include <cstdlib>
+#include <vector>
+
+namespace ComputerVisionProjects {
+
+struct ContourPoint {
+  int row = 0;
+  int column = 0;
+};
+
+// Chain code directions, counterclockwise from east:
+//   3 2 1
+//   4 . 0
+//   5 6 7
+// so code d moves by (kChainRowStep[d], kChainColumnStep[d]).
+extern const int kChainRowStep[8];
+extern const int kChainColumnStep[8];
+
+// Outer boundary of one object.
+struct Contour {
+  int label = 0;
+  // First pixel of the object in raster order; the chain starts and
+  // ends there.
+  ContourPoint start;
+  // One code per move from boundary pixel to boundary pixel (empty for
+  // a single pixel).
+  std::vector<unsigned char> chain;
+  // Length of the boundary: 1 per straight move, sqrt(2) per diagonal.
+  double perimeter = 0;
+  // Area enclosed by the polygon through the boundary pixel centers.
+  double area = 0;
+  // perimeter^2 / (4 pi area): 1 for a disc, larger for elongated or
+  // ragged shapes, 0 when the contour encloses no area.
+  double compactness = 0;
+};
+
+// Traces the outer contour of the object that has start as its first
+// pixel in raster order (the object with label labels[start]). Only
+// pixels next to the boundary are read, so the time is proportional to
+// the length of the contour, not to the area of the object.
+// Returns false if start is background or not the object's first pixel.
+bool TraceContour(const std::vector<int> &labels, size_t num_rows,
+                  size_t num_columns, ContourPoint start, Contour *contour);
+
+// Traces the contour of every object, in the raster order of their
+// first pixels. Finding the first pixels takes one scan of the labels.
+// Returns the number of contours.
+int TraceContours(const std::vector<int> &labels, size_t num_rows,
+                  size_t num_columns, std::vector<Contour> *contours);
+
+// Decodes the chain into the boundary pixels, starting at start.
+void ContourPoints(const Contour &contour, std::vector<ContourPoint> *points);
+
+// Closed polygon approximating the contour (Ramer-Douglas-Peucker): no
+// boundary pixel is farther than tolerance from the polygon. The first
+// vertex is the contour's start and the last edge closes the polygon.
+void ApproximatePolygon(const Contour &contour, double tolerance,
+                        std::vector<ContourPoint> *polygon);
+
+}  // namespace ComputerVisionProjects
+
+#endif  // COMPUTER_VISION_CONTOUR_H_
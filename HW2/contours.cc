@@ -0,0 +1,100 @@
+/*
+Name: Kevin Fang
+File: contours.cc
+Description:
+    The program, contours.cc, traces the outer contour of every object of a labeled image
+    (the output of p2). Each contour is followed along the boundary (contour.cc), so the
+    interior pixels of the objects are never visited.
+    The generated text file has a line for each object with the following values in that order:
+    object label, row and column of the contour's start (the object's first pixel),
+    perimeter, enclosed area, compactness (perimeter^2 / (4 pi area)),
+    the chain code (one digit per move, 0 = east, counterclockwise up to 7 = south-east),
+    the number of vertices of the approximating polygon, and the row and column of each vertex.
+    Separate the aforementioned values with blanks (space).
+    The output image shows the approximating polygons.
+
+To run this program after compiling with the makefile (make all):
+    ./contours <input_labeled_image.pgm> <output_contours.txt> <output_image.pgm> [<polygon tolerance>]
+    Ex: ./contours labeled_two_objects.pgm contours.txt contour_image.pgm 1.5
+*/
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include "contour.h"
+#include "image.h"
+#include "label_map.h"
+
+using namespace std;
+using namespace ComputerVisionProjects;
+
+int main(int argc, char* argv[]) {
+    if (argc != 4 && argc != 5) {
+        cerr << "Usage: " << argv[0] << " <input_labeled_image.pgm> <output_contours.txt> <output_image.pgm>"
+             << " [<polygon tolerance>]" << endl;
+        return 1;
+    }
+
+    const string input_filename = argv[1];
+    const string output_contours_filename = argv[2];
+    const string output_image_filename = argv[3];
+    // Largest distance (in pixels) between the contour and its polygon
+    const double tolerance = (argc == 5) ? atof(argv[4]) : 1.0;
+
+    vector<int> labels;
+    size_t rows, cols;
+    if (!ReadLabelMap(input_filename, &labels, &rows, &cols)) {
+        cerr << "Error reading labeled image." << endl;
+        return 1;
+    }
+
+    vector<Contour> contours;
+    TraceContours(labels, rows, cols, &contours);
+
+    ofstream out(output_contours_filename);
+    if (!out.is_open()) {
+        cerr << "Error opening output file: " << output_contours_filename << endl;
+        return 1;
+    }
+
+    Image output_image;
+    output_image.AllocateSpaceAndSetSize(rows, cols);
+    output_image.SetNumberGrayLevels(255);
+    for (size_t i = 0; i < rows; ++i) {
+        for (size_t j = 0; j < cols; ++j) {
+            output_image.SetPixel(i, j, 0);
+        }
+    }
+
+    vector<ContourPoint> polygon;
+    for (const Contour &contour : contours) {
+        ApproximatePolygon(contour, tolerance, &polygon);
+
+        out << contour.label << " " << contour.start.row << " " << contour.start.column << " "
+            << contour.perimeter << " " << contour.area << " " << contour.compactness << " ";
+        // A single pixel has no moves; write "-" so the line keeps its columns
+        if (contour.chain.empty()) out << "-";
+        for (unsigned char code : contour.chain) out << static_cast<char>('0' + code);
+        out << " " << polygon.size();
+        for (const ContourPoint &vertex : polygon) out << " " << vertex.row << " " << vertex.column;
+        out << "\n";
+
+        // Polygon edges, the last one closing the polygon
+        for (size_t k = 0; k < polygon.size(); ++k) {
+            const ContourPoint &a = polygon[k];
+            const ContourPoint &b = polygon[(k + 1) % polygon.size()];
+            DrawLine(a.row, a.column, b.row, b.column, 255, &output_image);
+        }
+    }
+    out.close();
+
+    if (!WriteImage(output_image_filename, output_image)) {
+        cerr << "Error writing output image." << endl;
+        return 1;
+    }
+
+    cout << contours.size() << " contours traced." << endl;
+    cout << "Contours saved as: " << output_contours_filename << endl;
+    cout << "Output image saved as: " << output_image_filename << endl;
+    return 0;
+}
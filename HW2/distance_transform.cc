@@ -0,0 +1,115 @@
+// Name: Kevin Fang
+// Distance transforms of binary masks: the distance from every object
+// pixel to the nearest background pixel.
+
+#include "distance_transform.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+
+using namespace std;
+
+namespace ComputerVisionProjects {
+
+namespace {
+
+// Runs body(begin, end) over [0, count) split into num_threads
+// contiguous ranges, one thread each.
+template <typename Body>
+void ParallelFor(int count, int num_threads, Body body) {
+  num_threads = max(1, min(num_threads, count));
+  vector<thread> threads;
+  for (int t = 1; t < num_threads; ++t)
+    threads.emplace_back(body, static_cast<long>(count) * t / num_threads,
+                         static_cast<long>(count) * (t + 1) / num_threads);
+  body(0, count / num_threads);
+  for (thread &worker : threads) worker.join();
+}
+
+}  // namespace
+
+int EuclideanDistanceTransform(const vector<unsigned char> &mask, size_t num_rows,
+                               size_t num_columns, int num_threads,
+                               vector<int> *squared_distances, vector<int> *nearest) {
+  if (squared_distances == nullptr) abort();
+  const int rows = num_rows;
+  const int cols = num_columns;
+  if (num_threads <= 0) num_threads = max(1u, thread::hardware_concurrency());
+
+  // Vertical pass: the nearest background row in every column, found by
+  // a downward and an upward sweep over whole rows (so memory is read in
+  // order), with the columns split among the threads. Rows -1 and
+  // num_rows, just outside the image, are background.
+  vector<int> nearest_row(mask.size());
+  ParallelFor(cols, num_threads, [&](int begin, int end) {
+    for (int i = 0; i < rows; ++i) {
+      const unsigned char *mask_row = mask.data() + i * cols;
+      int *row = nearest_row.data() + i * cols;
+      const int *above = (i > 0) ? row - cols : nullptr;
+      for (int j = begin; j < end; ++j)
+        row[j] = !mask_row[j] ? i : (above != nullptr ? above[j] : -1);
+    }
+    for (int i = rows - 1; i >= 0; --i) {
+      int *row = nearest_row.data() + i * cols;
+      const int *below = (i < rows - 1) ? row + cols : nullptr;
+      for (int j = begin; j < end; ++j) {
+        const int next = (below != nullptr) ? below[j] : rows;
+        if (next - i < i - row[j]) row[j] = next;
+      }
+    }
+  });
+
+  // Horizontal pass: along each row, the distance is the lower envelope
+  // of the parabolas (x - q)^2 + f(q), f(q) being the squared vertical
+  // distance of column q. Columns -1 and num_columns, just outside the
+  // image, are background (f = 0).
+  squared_distances->resize(mask.size());
+  if (nearest != nullptr) nearest->resize(mask.size());
+  ParallelFor(rows, num_threads, [&](int begin, int end) {
+    vector<int> vertices(cols + 2);   // Columns of the parabolas in the envelope.
+    vector<double> bounds(cols + 3);  // Where each parabola starts being lowest.
+    vector<int64_t> f(cols + 2);      // f(q) at index q + 1.
+    for (int i = begin; i < end; ++i) {
+      const int *row = nearest_row.data() + i * cols;
+      for (int q = 0; q < cols; ++q) {
+        const int64_t dy = row[q] - i;
+        f[q + 1] = dy * dy;
+      }
+      f[0] = f[cols + 1] = 0;
+
+      int k = -1;
+      for (int q = -1; q <= cols; ++q) {
+        double s = 0;
+        while (k >= 0) {
+          const int v = vertices[k];
+          s = static_cast<double>((f[q + 1] + int64_t{q} * q) - (f[v + 1] + int64_t{v} * v)) /
+              (2.0 * (q - v));
+          if (s > bounds[k]) break;
+          --k;
+        }
+        ++k;
+        vertices[k] = q;
+        bounds[k] = (k == 0) ? -1e300 : s;
+        bounds[k + 1] = 1e300;
+      }
+
+      int *out = squared_distances->data() + i * cols;
+      int *nearest_out = (nearest != nullptr) ? nearest->data() + i * cols : nullptr;
+      int segment = 0;
+      for (int x = 0; x < cols; ++x) {
+        while (bounds[segment + 1] < x) ++segment;
+        const int v = vertices[segment];
+        const int64_t dx = x - v;
+        out[x] = static_cast<int>(dx * dx + f[v + 1]);
+        if (nearest_out == nullptr) continue;
+        const bool inside = v >= 0 && v < cols && row[v] >= 0 && row[v] < rows;
+        nearest_out[x] = inside ? row[v] * cols + v : -1;
+      }
+    }
+  });
+  return squared_distances->empty()
+      ? 0 : *max_element(squared_distances->begin(), squared_distances->end());
+}
+
+}  // namespace ComputerVisionProjects
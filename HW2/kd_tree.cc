@@ -0,0 +1,80 @@
+// Name: Kevin Fang
+// A static k-d tree for nearest-neighbor queries over a fixed set of
+// points, such as the feature vectors of a database of objects.
+
+#include "kd_tree.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace ComputerVisionProjects {
+
+void KdTree::Build(const vector<double> &points, int dimensions) {
+  if (dimensions <= 0 || points.size() % dimensions != 0) abort();
+  dimensions_ = dimensions;
+  const int num_points = points.size() / dimensions;
+  indices_.resize(num_points);
+  for (int i = 0; i < num_points; ++i) indices_[i] = i;
+  BuildRange(points, 0, num_points, 0);
+
+  points_.resize(points.size());
+  for (int i = 0; i < num_points; ++i) {
+    copy(&points[indices_[i] * dimensions], &points[indices_[i] * dimensions] + dimensions,
+         &points_[i * dimensions]);
+  }
+}
+
+void KdTree::BuildRange(const vector<double> &points, int begin, int end, int depth) {
+  if (end - begin <= 1) return;
+  const int axis = depth % dimensions_;
+  const int middle = begin + (end - begin) / 2;
+  nth_element(indices_.begin() + begin, indices_.begin() + middle, indices_.begin() + end,
+              [&](int a, int b) {
+                return points[a * dimensions_ + axis] < points[b * dimensions_ + axis];
+              });
+  BuildRange(points, begin, middle, depth + 1);
+  BuildRange(points, middle + 1, end, depth + 1);
+}
+
+int KdTree::Nearest(const double *query, double *distance_squared) const {
+  if (query == nullptr || distance_squared == nullptr) abort();
+  int best = -1;
+  *distance_squared = 0;
+  double best_distance = 0;
+  Search(0, indices_.size(), 0, query, &best, &best_distance);
+  if (best < 0) return -1;
+  *distance_squared = best_distance;
+  return indices_[best];
+}
+
+void KdTree::Search(int begin, int end, int depth, const double *query,
+                    int *best, double *best_distance) const {
+  if (begin >= end) return;
+  const int middle = begin + (end - begin) / 2;
+  const double *point = &points_[middle * dimensions_];
+
+  double distance = 0;
+  for (int d = 0; d < dimensions_; ++d) {
+    const double delta = query[d] - point[d];
+    distance += delta * delta;
+  }
+  if (*best < 0 || distance < *best_distance) {
+    *best = middle;
+    *best_distance = distance;
+  }
+
+  // Descend on the query's side first; the other side can only hold a
+  // closer point if the splitting plane is closer than the best so far.
+  const int axis = depth % dimensions_;
+  const double delta = query[axis] - point[axis];
+  if (delta < 0) {
+    Search(begin, middle, depth + 1, query, best, best_distance);
+    if (delta * delta < *best_distance) Search(middle + 1, end, depth + 1, query, best, best_distance);
+  } else {
+    Search(middle + 1, end, depth + 1, query, best, best_distance);
+    if (delta * delta < *best_distance) Search(begin, middle, depth + 1, query, best, best_distance);
+  }
+}
+
+}  // namespace ComputerVisionProjects
@@ -0,0 +1,49 @@
+// Name: Kevin Fang
+// A static k-d tree for nearest-neighbor queries over a fixed set of
+// points, such as the feature vectors of a database of objects.
+
+#ifndef COMPUTER_VISION_KD_TREE_H_
+#define COMPUTER_VISION_KD_TREE_H_
+
+#include <cstdlib>
+#include <vector>
+
+namespace ComputerVisionProjects {
+
+// Sample usage:
+//   KdTree tree;
+//   tree.Build(points, 3);  // points holds x0 y0 z0 x1 y1 z1 ...
+//   double distance_squared;
+//   const int nearest = tree.Nearest(query, &distance_squared);
+// The tree is balanced (median splits, cycling through the dimensions)
+// and stored implicitly in one array, so a query visits O(log n) nodes
+// on average.
+class KdTree {
+ public:
+  // points holds num_points x dimensions coordinates, point by point.
+  void Build(const std::vector<double> &points, int dimensions);
+
+  // Returns the index (in the points given to Build()) of the point
+  // closest to query (dimensions values), or -1 if the tree is empty.
+  // distance_squared gets the squared Euclidean distance to it.
+  int Nearest(const double *query, double *distance_squared) const;
+
+  size_t size() const { return indices_.size(); }
+  int dimensions() const { return dimensions_; }
+
+ private:
+  void BuildRange(const std::vector<double> &points, int begin, int end, int depth);
+  void Search(int begin, int end, int depth, const double *query,
+              int *best, double *best_distance) const;
+
+  int dimensions_ = 0;
+  // Points in tree order: the node of the range [begin, end) is its
+  // middle element, with the two halves as its subtrees.
+  std::vector<double> points_;
+  // Index given to Build() of each point in tree order.
+  std::vector<int> indices_;
+};
+
+}  // namespace ComputerVisionProjects
+
+#endif  // COMPUTER_VISION_KD_TREE_H_
@@ -0,0 +1,99 @@
+/*
+Name: Kevin Fang
+File: label_benchmark.cc
+Description:
+    The program, label_benchmark.cc, times the connected components labeling methods of
+    connected_components.cc on a binary image (as produced by p1.cc). Every method is run
+    the given number of times with 4- and 8-connectivity, its output is checked against the
+    two-pass labeling, and the average time per frame is printed.
+
+To run this program after compiling with the makefile (make label_benchmark):
+    ./label_benchmark <input_binary_image.pgm> [<iterations>]
+    Ex: ./p1 PgmImages/many_objects_1.pgm 128 binary_many_objects_1.pgm
+        ./label_benchmark binary_many_objects_1.pgm 200
+*/
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "image.h"
+#include "connected_components.h"
+
+using namespace std;
+using namespace ComputerVisionProjects;
+
+struct MethodEntry {
+    const char *name;
+    LabelingMethod method;
+};
+
+int main(int argc, char* argv[]) {
+    if (argc != 2 && argc != 3) {
+        cerr << "Usage: " << argv[0] << " <input_binary_image.pgm> [<iterations>]" << endl;
+        return 1;
+    }
+
+    const string input_filename = argv[1];
+    const int iterations = (argc == 3) ? stoi(argv[2]) : 100;
+
+    Image binary_image;
+    if (!ReadImage(input_filename, &binary_image)) {
+        cerr << "Error reading binary image." << endl;
+        return 1;
+    }
+    const size_t rows = binary_image.num_rows();
+    const size_t cols = binary_image.num_columns();
+
+    vector<unsigned char> mask;
+    ImageToMask(binary_image, &mask);
+
+    const MethodEntry methods[] = {
+        {"twopass", LabelingMethod::kTwoPass},
+        {"runs", LabelingMethod::kRuns},
+        {"parallel", LabelingMethod::kParallel},
+    };
+
+    for (Connectivity connectivity : {Connectivity::kFour, Connectivity::kEight}) {
+        const int neighbors = (connectivity == Connectivity::kEight) ? 8 : 4;
+
+        vector<int> reference;
+        const int reference_objects = LabelComponents(mask, rows, cols, connectivity, &reference);
+
+        for (const MethodEntry &entry : methods) {
+            vector<int> labels;
+            int num_objects = 0;
+            const auto start = chrono::steady_clock::now();
+            for (int k = 0; k < iterations; ++k) {
+                num_objects = LabelComponents(mask, rows, cols, connectivity, entry.method, &labels);
+            }
+            const auto stop = chrono::steady_clock::now();
+            const double milliseconds =
+                chrono::duration<double, milli>(stop - start).count() / iterations;
+
+            const bool same = (num_objects == reference_objects && labels == reference);
+            cout << neighbors << "-connected " << entry.name << ": " << num_objects << " objects, "
+                 << milliseconds << " ms per frame" << (same ? "" : " (MISMATCH)") << endl;
+            if (!same) return 1;
+        }
+
+        // The parallel method with an explicit number of strips, which also
+        // exercises the boundary merge on machines with few cores.
+        for (int threads : {2, 4, 8}) {
+            vector<int> labels;
+            int num_objects = 0;
+            const auto start = chrono::steady_clock::now();
+            for (int k = 0; k < iterations; ++k) {
+                num_objects = LabelComponentsParallel(mask, rows, cols, connectivity, threads, &labels);
+            }
+            const auto stop = chrono::steady_clock::now();
+            const double milliseconds =
+                chrono::duration<double, milli>(stop - start).count() / iterations;
+
+            const bool same = (num_objects == reference_objects && labels == reference);
+            cout << neighbors << "-connected parallel x" << threads << ": " << num_objects << " objects, "
+                 << milliseconds << " ms per frame" << (same ? "" : " (MISMATCH)") << endl;
+            if (!same) return 1;
+        }
+    }
+    return 0;
+}
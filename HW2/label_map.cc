@@ -0,0 +1,179 @@
+// Name: Kevin Fang
+// Reading and writing label images (label maps) without the 255
+// label limit of 8-bit pgm images, plus a color-mapped preview.
+// Labels are kept in memory as 32-bit ints in a flat row-major vector.
+
+#include "label_map.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+
+namespace ComputerVisionProjects {
+
+namespace {
+
+const char kLabel32Magic[] = "CVLABEL32\n";
+
+// Reads the next header line that is not a comment.
+bool ReadHeaderLine(FILE *input, char *line, int size) {
+  do {
+    if (fgets(line, size, input) == nullptr) return false;
+  } while (*line == '#');
+  return true;
+}
+
+bool WriteLabel32(FILE *output, const vector<int> &labels,
+                  size_t num_rows, size_t num_columns) {
+  fputs(kLabel32Magic, output);
+  fprintf(output, "%zu %zu\n", num_columns, num_rows);
+  vector<unsigned char> row(num_columns * 4);
+  for (size_t i = 0; i < num_rows; ++i) {
+    for (size_t j = 0; j < num_columns; ++j) {
+      const uint32_t label = labels[i * num_columns + j];
+      for (int b = 0; b < 4; ++b) row[j * 4 + b] = (label >> (8 * b)) & 0xff;
+    }
+    if (fwrite(row.data(), 1, row.size(), output) != row.size()) return false;
+  }
+  return true;
+}
+
+bool WritePgm16(FILE *output, const vector<int> &labels,
+                size_t num_rows, size_t num_columns, int max_label) {
+  fprintf(output, "P5\n");
+  fprintf(output, "# label map\n");
+  fprintf(output, "%zu %zu\n%d\n", num_columns, num_rows, max(max_label, 1));
+  const size_t bytes = max_label > 255 ? 2 : 1;
+  vector<unsigned char> row(num_columns * bytes);
+  for (size_t i = 0; i < num_rows; ++i) {
+    for (size_t j = 0; j < num_columns; ++j) {
+      const int label = labels[i * num_columns + j];
+      if (bytes == 2) {
+        row[2 * j] = label >> 8;
+        row[2 * j + 1] = label & 0xff;
+      } else {
+        row[j] = label;
+      }
+    }
+    if (fwrite(row.data(), 1, row.size(), output) != row.size()) return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+bool WriteLabelMap(const string &filename, const vector<int> &labels,
+                   size_t num_rows, size_t num_columns) {
+  if (labels.size() != num_rows * num_columns) abort();
+  FILE *output = fopen(filename.c_str(), "wb");
+  if (output == 0) {
+    cout << "WriteLabelMap: cannot open file" << endl;
+    return false;
+  }
+
+  const int max_label = labels.empty() ? 0 : *max_element(labels.begin(), labels.end());
+  const bool ok = (max_label <= 65535)
+      ? WritePgm16(output, labels, num_rows, num_columns, max_label)
+      : WriteLabel32(output, labels, num_rows, num_columns);
+  fclose(output);
+  if (!ok) cout << "WriteLabelMap: could not write" << endl;
+  return ok;
+}
+
+bool ReadLabelMap(const string &filename, vector<int> *labels,
+                  size_t *num_rows, size_t *num_columns) {
+  if (labels == nullptr || num_rows == nullptr || num_columns == nullptr) abort();
+  FILE *input = fopen(filename.c_str(), "rb");
+  if (input == 0) {
+    cout << "ReadLabelMap: Cannot open file" << endl;
+    return false;
+  }
+
+  char line[1024];
+  if (fgets(line, sizeof line, input) == nullptr ||
+      (strcmp(line, "P5\n") != 0 && strcmp(line, kLabel32Magic) != 0)) {
+    fclose(input);
+    cout << "ReadLabelMap: Expected .pgm or label file" << endl;
+    return false;
+  }
+  const bool label32 = strcmp(line, kLabel32Magic) == 0;
+
+  int columns = 0, rows = 0, levels = 255;
+  if (!ReadHeaderLine(input, line, sizeof line) ||
+      sscanf(line, "%d %d", &columns, &rows) != 2 ||
+      (!label32 && (!ReadHeaderLine(input, line, sizeof line) ||
+                    sscanf(line, "%d", &levels) != 1))) {
+    fclose(input);
+    cout << "ReadLabelMap: bad header" << endl;
+    return false;
+  }
+
+  *num_rows = rows;
+  *num_columns = columns;
+  labels->resize(static_cast<size_t>(rows) * columns);
+  const size_t bytes = label32 ? 4 : (levels > 255 ? 2 : 1);
+  vector<unsigned char> row(columns * bytes);
+  for (int i = 0; i < rows; ++i) {
+    if (fread(row.data(), 1, row.size(), input) != row.size()) {
+      fclose(input);
+      cout << "ReadLabelMap: short file" << endl;
+      return false;
+    }
+    int *label = &(*labels)[static_cast<size_t>(i) * columns];
+    for (int j = 0; j < columns; ++j) {
+      if (bytes == 4) {
+        label[j] = row[4 * j] | (row[4 * j + 1] << 8) | (row[4 * j + 2] << 16) |
+                   (static_cast<uint32_t>(row[4 * j + 3]) << 24);
+      } else if (bytes == 2) {
+        label[j] = (row[2 * j] << 8) | row[2 * j + 1];
+      } else {
+        label[j] = row[j];
+      }
+    }
+  }
+
+  fclose(input);
+  return true;
+}
+
+bool WriteLabelPreview(const string &filename, const vector<int> &labels,
+                       size_t num_rows, size_t num_columns) {
+  FILE *output = fopen(filename.c_str(), "wb");
+  if (output == 0) {
+    cout << "WriteLabelPreview: cannot open file" << endl;
+    return false;
+  }
+  fprintf(output, "P6\n#\n%zu %zu\n255\n", num_columns, num_rows);
+
+  vector<unsigned char> row(num_columns * 3);
+  for (size_t i = 0; i < num_rows; ++i) {
+    for (size_t j = 0; j < num_columns; ++j) {
+      const int label = labels[i * num_columns + j];
+      unsigned char *rgb = &row[3 * j];
+      if (label == 0) {
+        rgb[0] = rgb[1] = rgb[2] = 0;
+        continue;
+      }
+      // Multiplicative hashing spreads consecutive labels over the
+      // color cube; every channel stays >= 64 so objects aren't black.
+      const uint32_t hash = static_cast<uint32_t>(label) * 2654435761u;
+      rgb[0] = 64 + (hash >> 24) % 192;
+      rgb[1] = 64 + (hash >> 16 & 0xff) % 192;
+      rgb[2] = 64 + (hash >> 8 & 0xff) % 192;
+    }
+    if (fwrite(row.data(), 1, row.size(), output) != row.size()) {
+      fclose(output);
+      cout << "WriteLabelPreview: could not write" << endl;
+      return false;
+    }
+  }
+
+  fclose(output);
+  return true;
+}
+
+}  // namespace ComputerVisionProjects
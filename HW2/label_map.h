@@ -0,0 +1,39 @@
+// Name: Kevin Fang
+// Reading and writing label images (label maps) without the 255
+// label limit of 8-bit pgm images, plus a color-mapped preview.
+// Labels are kept in memory as 32-bit ints in a flat row-major vector.
+
+#ifndef COMPUTER_VISION_LABEL_MAP_H_
+#define COMPUTER_VISION_LABEL_MAP_H_
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace ComputerVisionProjects {
+
+// Writes labels (num_rows x num_columns, row-major) into filename.
+// If the largest label is at most 65535 the file is a 16-bit pgm image
+// (maxval = largest label, two big-endian bytes per pixel), which any
+// pgm reader understands. Otherwise it is a 32-bit label file:
+//   "CVLABEL32\n" "<num_columns> <num_rows>\n" followed by one
+//   little-endian 32-bit label per pixel, row by row.
+// Returns true if everything is OK, false otherwise.
+bool WriteLabelMap(const std::string &filename, const std::vector<int> &labels,
+                   size_t num_rows, size_t num_columns);
+
+// Reads a label map written by WriteLabelMap(), or any 8-bit pgm image
+// (like the labeled images of the old p2).
+// Returns true if everything is OK, false otherwise.
+bool ReadLabelMap(const std::string &filename, std::vector<int> *labels,
+                  size_t *num_rows, size_t *num_columns);
+
+// Writes a color (ppm) preview of the labels: background is black and
+// every object gets its own color, derived from its label.
+// Returns true if everything is OK, false otherwise.
+bool WriteLabelPreview(const std::string &filename, const std::vector<int> &labels,
+                       size_t num_rows, size_t num_columns);
+
+}  // namespace ComputerVisionProjects
+
+#endif  // COMPUTER_VISION_LABEL_MAP_H_
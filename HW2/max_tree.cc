@@ -0,0 +1,221 @@
+// Name: Kevin Fang
+// Max-tree (component tree) of a gray-level image: the connected
+// components of the pixels above every threshold, nested into
+// one tree, so that the objects p1 + p2 would find at any threshold can
+// be read off the tree without thresholding and labeling the image
+// again.
+
+#include "max_tree.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace ComputerVisionProjects {
+
+void MaxTree::Build(const vector<unsigned char> &gray, size_t num_rows, size_t num_columns,
+                    Connectivity connectivity) {
+  if (gray.size() != num_rows * num_columns) abort();
+  num_rows_ = num_rows;
+  num_columns_ = num_columns;
+  gray_ = gray;
+  const int rows = num_rows;
+  const int cols = num_columns;
+  const int n = rows * cols;
+
+  // Counting sort, darkest first; equal values stay in raster order.
+  int start[257] = {0};
+  for (int p = 0; p < n; ++p) ++start[gray[p] + 1];
+  for (int v = 0; v < 256; ++v) start[v + 1] += start[v];
+  sorted_.resize(n);
+  for (int p = 0; p < n; ++p) sorted_[start[gray[p]]++] = p;
+
+  // Pixels are added from the brightest down. Each one becomes the
+  // parent of the (roots of the) trees of its already added neighbors.
+  // zpar is the union-find over the added pixels; representative maps a
+  // union-find root to the tree node that currently stands for its set.
+  parent_.assign(n, 0);
+  vector<int> zpar(n, -1), representative(n, 0);
+  vector<unsigned char> rank(n, 0);
+  auto find = [&zpar](int p) {
+    while (zpar[p] != p) {
+      zpar[p] = zpar[zpar[p]];
+      p = zpar[p];
+    }
+    return p;
+  };
+  const bool eight = (connectivity == Connectivity::kEight);
+  for (int k = n - 1; k >= 0; --k) {
+    const int p = sorted_[k];
+    parent_[p] = p;
+    zpar[p] = p;
+    representative[p] = p;
+    int root = p;
+    const int i = p / cols;
+    const int j = p % cols;
+    auto visit = [&](int r, int c) {
+      if (r < 0 || r >= rows || c < 0 || c >= cols) return;
+      const int q = r * cols + c;
+      if (zpar[q] < 0) return;  // Not added yet.
+      int other = find(q);
+      if (other == root) return;
+      parent_[representative[other]] = p;
+      if (rank[root] < rank[other]) swap(root, other);
+      zpar[other] = root;
+      representative[root] = p;
+      if (rank[root] == rank[other]) ++rank[root];
+    };
+    visit(i, j - 1);
+    visit(i, j + 1);
+    visit(i - 1, j);
+    visit(i + 1, j);
+    if (eight) {
+      visit(i - 1, j - 1);
+      visit(i - 1, j + 1);
+      visit(i + 1, j - 1);
+      visit(i + 1, j + 1);
+    }
+  }
+
+  // Point every pixel at the representative of its node: a pixel whose
+  // parent has the same value belongs to the parent's node.
+  for (int k = 0; k < n; ++k) {
+    const int p = sorted_[k];
+    const int q = parent_[p];
+    if (gray[parent_[q]] == gray[q]) parent_[p] = parent_[q];
+  }
+
+  // Number the nodes darkest first, so a parent always comes before its
+  // children, and gather every pixel into its own node.
+  node_of_.assign(n, -1);
+  node_pixel_.clear();
+  node_parent_.clear();
+  node_level_.clear();
+  node_properties_.clear();
+  for (int k = 0; k < n; ++k) {
+    const int p = sorted_[k];
+    const bool is_root = (k == 0);
+    if (!is_root && gray[parent_[p]] == gray[p]) continue;
+    node_of_[p] = node_pixel_.size();
+    node_pixel_.push_back(p);
+    node_parent_.push_back(is_root ? -1 : node_of_[parent_[p]]);
+    node_level_.push_back(gray[p]);
+  }
+  node_properties_.resize(node_pixel_.size());
+  for (int p = 0; p < n; ++p) node_properties_[NodeOf(p)].Add(p / cols, p % cols);
+
+  // A side between two pixels of different values is on the boundary of
+  // the components that hold the brighter pixel but not the darker one:
+  // the brighter pixel's node and its ancestors below the darker pixel's
+  // node. Count it +1 at the first and -1 at the second, so that the sums
+  // over the subtrees below are the perimeters. Image border sides are on
+  // the boundary of every component that holds the pixel.
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) {
+      const int p = i * cols + j;
+      const int node = NodeOf(p);
+      node_properties_[node].perimeter +=
+          (i == 0) + (i == rows - 1) + (j == 0) + (j == cols - 1);
+      auto side = [&](int q) {
+        if (gray[q] == gray[p]) return;
+        const int other = NodeOf(q);
+        const bool brighter = gray[p] > gray[q];
+        ++node_properties_[brighter ? node : other].perimeter;
+        --node_properties_[brighter ? other : node].perimeter;
+      };
+      if (j + 1 < cols) side(p + 1);
+      if (i + 1 < rows) side(p + cols);
+    }
+  }
+  // The pixels around a grid point that a component holds are those
+  // whose nodes are in its subtree. Follow each node up the tree until
+  // the paths meet: a node holds the union of the groups that meet there,
+  // so it gets the corners of the union minus those already counted below
+  // it.
+  for (int i = 0; i <= rows; ++i) {
+    for (int j = 0; j <= cols; ++j) {
+      int group_node[4], group_mask[4];
+      int groups = 0;
+      for (int k = 0; k < 4; ++k) {
+        const int r = i - 1 + k / 2, c = j - 1 + k % 2;
+        if (r < 0 || r >= rows || c < 0 || c >= cols) continue;
+        const int node = NodeOf(r * cols + c);
+        int g = 0;
+        while (g < groups && group_node[g] != node) ++g;
+        if (g == groups) {
+          group_node[groups] = node;
+          group_mask[groups++] = 0;
+        }
+        group_mask[g] |= 1 << k;
+      }
+      for (int g = 0; g < groups; ++g)
+        node_properties_[group_node[g]].corners += BoundaryCorners(group_mask[g]);
+      while (groups > 1) {
+        // The group at the brightest node moves up to the parent, where
+        // it may meet another one.
+        int g = 0;
+        for (int h = 1; h < groups; ++h)
+          if (node_level_[group_node[h]] > node_level_[group_node[g]]) g = h;
+        group_node[g] = node_parent_[group_node[g]];
+        for (int h = 0; h < groups; ++h) {
+          if (h == g || group_node[h] != group_node[g]) continue;
+          const int both = group_mask[g] | group_mask[h];
+          node_properties_[group_node[h]].corners += BoundaryCorners(both) -
+                                                     BoundaryCorners(group_mask[g]) -
+                                                     BoundaryCorners(group_mask[h]);
+          group_mask[h] = both;
+          group_node[g] = group_node[--groups];
+          group_mask[g] = group_mask[groups];
+          break;
+        }
+      }
+    }
+  }
+
+  // Children into parents, brightest nodes first.
+  for (int node = static_cast<int>(node_pixel_.size()) - 1; node > 0; --node)
+    node_properties_[node_parent_[node]].Merge(node_properties_[node]);
+}
+
+int MaxTree::Components(int threshold, int min_area,
+                        vector<RegionProperties> *components) const {
+  if (components == nullptr) abort();
+  components->clear();
+  // A node is an object at this threshold if it is above it and its
+  // parent isn't.
+  for (size_t node = 0; node < node_pixel_.size(); ++node) {
+    if (node_level_[node] <= threshold) continue;
+    const int parent = node_parent_[node];
+    if (parent >= 0 && node_level_[parent] > threshold) continue;
+    if (node_properties_[node].area < min_area) continue;
+    components->push_back(node_properties_[node]);
+    components->back().label = node;
+  }
+  return components->size();
+}
+
+int MaxTree::Label(int threshold, vector<int> *labels) const {
+  if (labels == nullptr) abort();
+  // The object each node belongs to at this threshold (-1 below it).
+  vector<int> object(node_pixel_.size(), -1);
+  for (size_t node = 0; node < node_pixel_.size(); ++node) {
+    if (node_level_[node] <= threshold) continue;
+    const int parent = node_parent_[node];
+    object[node] = (parent >= 0 && node_level_[parent] > threshold) ? object[parent] : node;
+  }
+
+  const int n = gray_.size();
+  labels->assign(n, 0);
+  vector<int> renumbered(node_pixel_.size(), 0);
+  int count = 0;
+  for (int p = 0; p < n; ++p) {
+    const int node = NodeOf(p);
+    if (object[node] < 0) continue;
+    int &label = renumbered[object[node]];
+    if (label == 0) label = ++count;
+    (*labels)[p] = label;
+  }
+  return count;
+}
+
+}  // namespace ComputerVisionProjects
@@ -0,0 +1,78 @@
+// Name: Kevin Fang
+// Max-tree (component tree) of a gray-level image: the connected
+// components of the pixels above every threshold, nested into
+// one tree, so that the objects p1 + p2 would find at any threshold can
+// be read off the tree without thresholding and labeling the image
+// again.
+
+#ifndef COMPUTER_VISION_MAX_TREE_H_
+#define COMPUTER_VISION_MAX_TREE_H_
+
+#include <cstdlib>
+#include <vector>
+
+#include "connected_components.h"
+#include "region_properties.h"
+
+namespace ComputerVisionProjects {
+
+// Sample usage:
+//   MaxTree tree;
+//   tree.Build(gray, rows, cols, Connectivity::kFour);
+//   for (int threshold = 0; threshold < 255; ++threshold) {
+//     tree.Components(threshold, min_area, &objects);
+//     ...
+//   }
+// A node of the tree is a connected set of pixels with value >= its
+// level, the pixels at exactly that level being its own; its children
+// are the brighter components inside it.
+class MaxTree {
+ public:
+  // Builds the tree of gray (num_rows x num_columns, row-major). Pixels
+  // are sorted by value with a counting sort and merged from the
+  // brightest down with a union-find (union by rank, path halving), so
+  // building is nearly linear in the number of pixels. The properties of
+  // every node (area, center, central moments, bounding box and
+  // perimeter, as p3 computes them) are accumulated at the same time.
+  void Build(const std::vector<unsigned char> &gray, size_t num_rows, size_t num_columns,
+             Connectivity connectivity);
+
+  // The objects of the binary image p1 would make with threshold
+  // (pixels with value > threshold), with at least min_area pixels.
+  // Reads only the nodes, not the pixels. Each object's label is the
+  // index of its node. Returns the number of objects.
+  int Components(int threshold, int min_area, std::vector<RegionProperties> *components) const;
+
+  // Labels the pixels with value > threshold exactly as p2 labels p1's
+  // binary image: 1..N in the raster order of each object's first pixel.
+  // Returns N.
+  int Label(int threshold, std::vector<int> *labels) const;
+
+  size_t num_nodes() const { return node_pixel_.size(); }
+
+ private:
+  // Node of pixel p.
+  int NodeOf(int p) const { return node_of_[p] >= 0 ? node_of_[p] : node_of_[parent_[p]]; }
+
+  size_t num_rows_ = 0;
+  size_t num_columns_ = 0;
+  std::vector<unsigned char> gray_;
+  // Pixels from the darkest to the brightest (the root comes first).
+  std::vector<int> sorted_;
+  // For each pixel, the pixel that represents its node; for a node's
+  // representative, the representative of its parent node (the root's
+  // is itself).
+  std::vector<int> parent_;
+  // Node index of each representative pixel, -1 for other pixels.
+  std::vector<int> node_of_;
+  // Per node: representative pixel, parent node (-1 at the root), level
+  // and the properties of all its pixels (descendants included).
+  std::vector<int> node_pixel_;
+  std::vector<int> node_parent_;
+  std::vector<int> node_level_;
+  std::vector<RegionProperties> node_properties_;
+};
+
+}  // namespace ComputerVisionProjects
+
+#endif  // COMPUTER_VISION_MAX_TREE_H_
@@ -0,0 +1,248 @@
+// Name: Kevin Fang
+// Binary morphology (erosion, dilation, opening, closing) on bit-packed
+// masks, to clean binary images between p1 and p2.
+// Masks are packed 64 pixels per word so that every word operation
+// handles 64 pixels at once.
+
+#include "morphology.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace ComputerVisionProjects {
+
+namespace {
+
+// Erosion is a minimum (AND) and dilation a maximum (OR) over the
+// element. Pixels outside the image take the value that leaves the
+// result unchanged (1 for AND, 0 for OR).
+struct AndOp {
+  static const uint64_t kFill = ~uint64_t{0};
+  static uint64_t Apply(uint64_t a, uint64_t b) { return a & b; }
+};
+
+struct OrOp {
+  static const uint64_t kFill = 0;
+  static uint64_t Apply(uint64_t a, uint64_t b) { return a | b; }
+};
+
+// Word i of a row of n words, or fill outside the row.
+inline uint64_t WordAt(const uint64_t *row, long i, long n, uint64_t fill) {
+  return (i >= 0 && i < n) ? row[i] : fill;
+}
+
+// destination bit p = source bit p + shift (toward lower bit indices).
+void ShiftDown(const uint64_t *source, long n, size_t shift, uint64_t fill,
+               uint64_t *destination) {
+  const long words = shift / 64;
+  const int bits = shift % 64;
+  for (long i = 0; i < n; ++i) {
+    const uint64_t low = WordAt(source, i + words, n, fill);
+    if (bits == 0) {
+      destination[i] = low;
+    } else {
+      destination[i] = (low >> bits) | (WordAt(source, i + words + 1, n, fill) << (64 - bits));
+    }
+  }
+}
+
+// destination bit p = source bit p - shift (toward higher bit indices);
+// source has n words and destination m words.
+void ShiftUp(const uint64_t *source, long n, size_t shift, uint64_t fill,
+             uint64_t *destination, long m) {
+  const long words = shift / 64;
+  const int bits = shift % 64;
+  for (long i = 0; i < m; ++i) {
+    const uint64_t high = WordAt(source, i - words, n, fill);
+    if (bits == 0) {
+      destination[i] = high;
+    } else {
+      destination[i] = (high << bits) | (WordAt(source, i - words - 1, n, fill) >> (64 - bits));
+    }
+  }
+}
+
+// Mask of the valid bits of the last word of a row.
+uint64_t LastWordMask(size_t num_columns) {
+  const int bits = num_columns % 64;
+  return bits == 0 ? ~uint64_t{0} : (uint64_t{1} << bits) - 1;
+}
+
+// Combines pixels j - before .. j - before + width - 1 of every row.
+// Each row is padded so that pixel j - before sits at bit j, then the
+// window is grown by doubling: F_2k(p) = F_k(p) op F_k(p + k).
+template <typename Op>
+void RowPass(const BitMask &input, int width, int before, BitMask *output) {
+  output->Resize(input.num_rows, input.num_columns);
+  if (width <= 1 || input.words.empty()) {
+    output->words = input.words;
+    return;
+  }
+  const long n = input.words_per_row;
+  const long padded_words = (input.num_columns + width - 1 + 63) / 64;
+  const uint64_t tail = LastWordMask(input.num_columns);
+  vector<uint64_t> row(n), padded(padded_words), shifted(padded_words);
+
+  for (size_t i = 0; i < input.num_rows; ++i) {
+    copy(&input.words[i * n], &input.words[i * n] + n, row.begin());
+    row[n - 1] = (row[n - 1] & tail) | (Op::kFill & ~tail);
+    ShiftUp(row.data(), n, before, Op::kFill, padded.data(), padded_words);
+
+    int length = 1;
+    while (2 * length <= width) {
+      ShiftDown(padded.data(), padded_words, length, Op::kFill, shifted.data());
+      for (long k = 0; k < padded_words; ++k) padded[k] = Op::Apply(padded[k], shifted[k]);
+      length *= 2;
+    }
+    if (length < width) {
+      ShiftDown(padded.data(), padded_words, width - length, Op::kFill, shifted.data());
+      for (long k = 0; k < padded_words; ++k) padded[k] = Op::Apply(padded[k], shifted[k]);
+    }
+
+    uint64_t *out = &output->words[i * n];
+    copy(padded.begin(), padded.begin() + n, out);
+    out[n - 1] &= tail;
+  }
+}
+
+// Combines rows i - before .. i - before + height - 1 with van Herk /
+// Gil-Werman: the padded column is cut into blocks of height rows, with
+// running prefixes (forward) and suffixes (backward) inside each block,
+// so every window is suffix[start] op prefix[end].
+template <typename Op>
+void ColumnPass(const BitMask &input, int height, int before, BitMask *output) {
+  output->Resize(input.num_rows, input.num_columns);
+  if (height <= 1 || input.words.empty()) {
+    output->words = input.words;
+    return;
+  }
+  const long n = input.words_per_row;
+  const long rows = input.num_rows;
+  const long padded_rows = rows + height - 1;
+  auto source = [&](long q) -> const uint64_t * {
+    const long i = q - before;
+    return (i >= 0 && i < rows) ? &input.words[i * n] : nullptr;
+  };
+
+  vector<uint64_t> prefix(padded_rows * n), suffix(padded_rows * n);
+  for (long q = 0; q < padded_rows; ++q) {
+    const uint64_t *s = source(q);
+    uint64_t *p = &prefix[q * n];
+    for (long k = 0; k < n; ++k) {
+      const uint64_t value = s ? s[k] : Op::kFill;
+      p[k] = (q % height == 0) ? value : Op::Apply(p[k - n], value);
+    }
+  }
+  for (long q = padded_rows - 1; q >= 0; --q) {
+    const uint64_t *s = source(q);
+    uint64_t *r = &suffix[q * n];
+    const bool block_end = (q % height == height - 1) || (q == padded_rows - 1);
+    for (long k = 0; k < n; ++k) {
+      const uint64_t value = s ? s[k] : Op::kFill;
+      r[k] = block_end ? value : Op::Apply(r[k + n], value);
+    }
+  }
+  for (long i = 0; i < rows; ++i) {
+    const uint64_t *r = &suffix[i * n];
+    const uint64_t *p = &prefix[(i + height - 1) * n];
+    uint64_t *out = &output->words[i * n];
+    for (long k = 0; k < n; ++k) out[k] = Op::Apply(r[k], p[k]);
+  }
+}
+
+// Erosion uses the element's window as is; dilation uses it reflected
+// about the origin, which only matters for even sizes, so that opening
+// and closing are idempotent.
+template <typename Op>
+void ApplyElement(const BitMask &input, const StructuringElement &element,
+                  bool reflect, BitMask *output) {
+  if (element.height < 1 || element.width < 1) abort();
+  const int before_row = reflect ? (element.height - 1) - element.height / 2 : element.height / 2;
+  const int before_column = reflect ? (element.width - 1) - element.width / 2 : element.width / 2;
+
+  if (element.shape == StructuringShape::kRectangle) {
+    BitMask rows_done;
+    RowPass<Op>(input, element.width, before_column, &rows_done);
+    ColumnPass<Op>(rows_done, element.height, before_row, output);
+    return;
+  }
+  BitMask horizontal;
+  RowPass<Op>(input, element.width, before_column, &horizontal);
+  ColumnPass<Op>(input, element.height, before_row, output);
+  for (size_t k = 0; k < output->words.size(); ++k)
+    output->words[k] = Op::Apply(output->words[k], horizontal.words[k]);
+}
+
+}  // namespace
+
+void BitMask::Resize(size_t rows, size_t columns) {
+  num_rows = rows;
+  num_columns = columns;
+  words_per_row = (columns + 63) / 64;
+  words.assign(num_rows * words_per_row, 0);
+}
+
+void PackMask(const vector<unsigned char> &mask, size_t num_rows,
+              size_t num_columns, BitMask *bits) {
+  if (bits == nullptr) abort();
+  bits->Resize(num_rows, num_columns);
+  for (size_t i = 0; i < num_rows; ++i) {
+    const unsigned char *row = mask.data() + i * num_columns;
+    uint64_t *out = bits->words.data() + i * bits->words_per_row;
+    for (size_t j = 0; j < num_columns; ++j)
+      if (row[j]) out[j / 64] |= uint64_t{1} << (j % 64);
+  }
+}
+
+void UnpackMask(const BitMask &bits, vector<unsigned char> *mask) {
+  if (mask == nullptr) abort();
+  mask->resize(bits.num_rows * bits.num_columns);
+  for (size_t i = 0; i < bits.num_rows; ++i) {
+    const uint64_t *row = bits.words.data() + i * bits.words_per_row;
+    unsigned char *out = mask->data() + i * bits.num_columns;
+    for (size_t j = 0; j < bits.num_columns; ++j) out[j] = (row[j / 64] >> (j % 64)) & 1;
+  }
+}
+
+void Erode(const BitMask &input, const StructuringElement &element, BitMask *output) {
+  if (output == nullptr) abort();
+  ApplyElement<AndOp>(input, element, false, output);
+}
+
+void Dilate(const BitMask &input, const StructuringElement &element, BitMask *output) {
+  if (output == nullptr) abort();
+  ApplyElement<OrOp>(input, element, true, output);
+}
+
+void Open(const BitMask &input, const StructuringElement &element, BitMask *output) {
+  if (output == nullptr) abort();
+  BitMask eroded;
+  Erode(input, element, &eroded);
+  Dilate(eroded, element, output);
+}
+
+void Close(const BitMask &input, const StructuringElement &element, BitMask *output) {
+  if (output == nullptr) abort();
+  BitMask dilated;
+  Dilate(input, element, &dilated);
+  Erode(dilated, element, output);
+}
+
+void ApplyMorphology(const vector<unsigned char> &mask, size_t num_rows,
+                     size_t num_columns, MorphologyOperation operation,
+                     const StructuringElement &element,
+                     vector<unsigned char> *output) {
+  if (output == nullptr) abort();
+  BitMask input, result;
+  PackMask(mask, num_rows, num_columns, &input);
+  switch (operation) {
+    case MorphologyOperation::kErode: Erode(input, element, &result); break;
+    case MorphologyOperation::kDilate: Dilate(input, element, &result); break;
+    case MorphologyOperation::kOpen: Open(input, element, &result); break;
+    case MorphologyOperation::kClose: Close(input, element, &result); break;
+  }
+  UnpackMask(result, output);
+}
+
+}  // namespace ComputerVisionProjects
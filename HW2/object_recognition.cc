@@ -0,0 +1,52 @@
+// Name: Kevin Fang
+// Recognition of objects against a database of object descriptors
+// (object_descriptions.txt files written by p3), indexed with a k-d
+// tree over rotation and scale invariant features.
+
+#include "object_recognition.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+using namespace std;
+
+namespace ComputerVisionProjects {
+
+void ObjectRecognizer::Features(const ObjectDescriptor &descriptor, double *features) const {
+  // Single pixels have hu1 = 0; keep their logarithm finite.
+  const double kTiny = 1e-12;
+  features[0] = descriptor.roundedness / options_.roundedness_tolerance;
+  features[1] = log(max(descriptor.hu1, kTiny)) / options_.relative_tolerance;
+  features[2] = log(max(descriptor.compactness, kTiny)) / options_.compactness_tolerance;
+}
+
+bool ObjectRecognizer::Build(const vector<ObjectDescriptor> &database,
+                             const RecognitionOptions &options) {
+  if (options.roundedness_tolerance <= 0 || options.relative_tolerance <= 0 ||
+      options.compactness_tolerance <= 0)
+    abort();
+  options_ = options;
+  vector<double> points(database.size() * kNumFeatures);
+  for (size_t i = 0; i < database.size(); ++i) {
+    if (database[i].hu1 < 0 || database[i].compactness < 0) {
+      cout << "ObjectRecognizer: database object " << database[i].label
+           << " has no hu1/compactness (regenerate it with p3)" << endl;
+      return false;
+    }
+    Features(database[i], &points[i * kNumFeatures]);
+  }
+  tree_.Build(points, kNumFeatures);
+  return true;
+}
+
+int ObjectRecognizer::Match(const ObjectDescriptor &object, double *distance) const {
+  double features[kNumFeatures];
+  Features(object, features);
+  double distance_squared;
+  const int nearest = tree_.Nearest(features, &distance_squared);
+  if (distance != nullptr) *distance = sqrt(distance_squared);
+  return (nearest >= 0 && distance_squared <= 1.0) ? nearest : -1;
+}
+
+}  // namespace ComputerVisionProjects
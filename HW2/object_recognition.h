@@ -0,0 +1,64 @@
+// Name: Kevin Fang
+// Recognition of objects against a database of object descriptors
+// (object_descriptions.txt files written by p3), indexed with a k-d
+// tree over rotation and scale invariant features.
+
+#ifndef COMPUTER_VISION_OBJECT_RECOGNITION_H_
+#define COMPUTER_VISION_OBJECT_RECOGNITION_H_
+
+#include <cstdlib>
+#include <vector>
+
+#include "kd_tree.h"
+#include "region_properties.h"
+
+namespace ComputerVisionProjects {
+
+// How far apart two objects may be and still match. Each feature is
+// divided by its tolerance, so an object matches a database object when
+// the Euclidean distance between their scaled features is at most 1.
+struct RecognitionOptions {
+  // Absolute tolerance on the roundedness (E_min / E_max, in [0, 1]).
+  double roundedness_tolerance = 0.05;
+  // Relative tolerance on hu1 (compared as logarithms, so 0.1 means
+  // about 10%).
+  double relative_tolerance = 0.1;
+  // Relative tolerance on the compactness, also on its logarithm. The
+  // estimated perimeter of a straight edge is within 4.5% of its length
+  // at any angle, so the compactness of one object varies by up to 20%
+  // (a logarithm of 0.18) as it turns; the rest is margin for small and
+  // ragged objects.
+  double compactness_tolerance = 0.25;
+};
+
+// Sample usage:
+//   ObjectRecognizer recognizer;
+//   recognizer.Build(database, RecognitionOptions());
+//   const int match = recognizer.Match(DescribeRegion(region));
+// Build() is O(n log n) in the database size and Match() takes
+// O(log n) on average, so large databases can be searched per frame.
+class ObjectRecognizer {
+ public:
+  // Indexes the database. Returns false if a descriptor doesn't have
+  // hu1 and compactness (files written before p3 computed them).
+  bool Build(const std::vector<ObjectDescriptor> &database,
+             const RecognitionOptions &options);
+
+  // Returns the index in the database of the object closest to object,
+  // or -1 if none is within the tolerances. distance (may be null) gets
+  // the scaled distance to the closest object.
+  int Match(const ObjectDescriptor &object, double *distance = nullptr) const;
+
+  size_t size() const { return tree_.size(); }
+
+ private:
+  static const int kNumFeatures = 3;
+  void Features(const ObjectDescriptor &descriptor, double *features) const;
+
+  RecognitionOptions options_;
+  KdTree tree_;
+};
+
+}  // namespace ComputerVisionProjects
+
+#endif  // COMPUTER_VISION_OBJECT_RECOGNITION_H_
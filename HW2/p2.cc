@@ -7,93 +7,72 @@ Description:
     is supposed to be painted with a different gray-level.
     The gray–level assigned to an object is its label.
 
+    Labeling is done by connected_components.cc with a flat union-find (DisjSets) over the
+    provisional labels, and objects are numbered 1, 2, 3, ... without gaps. Objects can be
+    4-connected (default, left and top neighbors) or 8-connected (diagonals too).
+
+    The labeling method can be "twopass" (default, pixel by pixel), "runs" (labels runs of
+    foreground pixels and merges the overlapping runs of consecutive rows) or "parallel"
+    (labels horizontal strips on all cores and merges them across the strip boundaries).
+    All of them give the same labels; "runs" is faster on masks that are mostly background,
+    and "parallel" scales with the number of cores on large frames.
+
+    The labeled image is written as a label map (label_map.cc): an ordinary pgm image while
+    there are at most 255 objects, a 16-bit pgm image up to 65535 objects, and a 32-bit label
+    file beyond that, so labels never wrap around. Since label values are hard to tell apart
+    as gray-levels, a color-mapped preview (ppm) can be written as well.
+
 To run this program after compiling with the makefile (make all):
-    ./p2 <input_binary_image.pgm> <labeled_image.pgm>
+    ./p2 <input_binary_image.pgm> <labeled_image.pgm> [<connectivity 4|8>] [<method twopass|runs|parallel>] [<preview.ppm>]
     Ex: ./p2 binary_two_objects.pgm labeled_two_objects.pgm
+    Ex: ./p2 binary_two_objects.pgm labeled_two_objects.pgm 8 runs labeled_two_objects_preview.ppm
 */
 #include <iostream>
+#include <string>
 #include <vector>
-#include <unordered_map>
 #include "image.h"
+#include "connected_components.h"
+#include "label_map.h"
 
 using namespace std;
 using namespace ComputerVisionProjects;
 
-int findLabel(int label, unordered_map<int, int>& label_equiv) {
-    while (label != label_equiv[label]) {
-        label = label_equiv[label];
-    }
-    return label;
-}
+// Labels are 32-bit ints, so there is no limit of 255 objects.
+// Returns the number of objects found
+int SegmentImage(const Image &input_image, vector<int> &labels, Connectivity connectivity,
+                 LabelingMethod method) {
+    vector<unsigned char> mask;
+    ImageToMask(input_image, &mask);
 
-void unionLabels(int label1, int label2, unordered_map<int, int>& label_equiv) {
-    int root1 = findLabel(label1, label_equiv);
-    int root2 = findLabel(label2, label_equiv);
-    if (root1 != root2) {
-        label_equiv[root2] = root1;
-    }
-}
-
-void SegmentImage(const Image &input_image, Image &output_image) {
-    int current_label = 1;
-    unordered_map<int, int> label_equiv;
-
-    int rows = input_image.num_rows();
-    int cols = input_image.num_columns();
-    output_image.AllocateSpaceAndSetSize(rows, cols);
-    output_image.SetNumberGrayLevels(255);
-
-    // First pass
-    for (int i = 0; i < rows; ++i) {
-        for (int j = 0; j < cols; ++j) {
-            if (input_image.GetPixel(i, j) == 0) {
-                output_image.SetPixel(i, j, 0);
-                continue;
-            }
-
-            int left_label = (j > 0) ? output_image.GetPixel(i, j - 1) : 0;
-            int top_label = (i > 0) ? output_image.GetPixel(i - 1, j) : 0;
-
-            if (left_label == 0 && top_label == 0) {
-                output_image.SetPixel(i, j, current_label);
-                label_equiv[current_label] = current_label;
-                ++current_label;
-            } else if (left_label != 0 && top_label == 0) {
-                // Label according to left neighbor
-                output_image.SetPixel(i, j, left_label);
-            } else if (top_label != 0 && left_label == 0) {
-                // Label according to top neighbor
-                output_image.SetPixel(i, j, top_label);
-            } else {
-                // Both neighbors are labeled, assign the smaller label and record equivalence
-                int min_label = min(left_label, top_label);
-                output_image.SetPixel(i, j, min_label);
-                if (left_label != top_label) {
-                    unionLabels(left_label, top_label, label_equiv);
-                }
-            }
-        }
-    }
-
-    // Second pass
-    for (int i = 0; i < rows; ++i) {
-        for (int j = 0; j < cols; ++j) {
-            int label = output_image.GetPixel(i, j);
-            if (label != 0) {
-                output_image.SetPixel(i, j, findLabel(label, label_equiv));
-            }
-        }
-    }
+    return LabelComponents(mask, input_image.num_rows(), input_image.num_columns(),
+                           connectivity, method, &labels);
 }
 
 int main(int argc, char* argv[]) {
-    if (argc != 3) {
-        std::cerr << "Usage: " << argv[0] << " <input_binary_image.pgm> <output_labeled_image.pgm>" << std::endl;
+    if (argc < 3 || argc > 6) {
+        std::cerr << "Usage: " << argv[0] << " <input_binary_image.pgm> <output_labeled_image.pgm> [<connectivity 4|8>] [<method twopass|runs|parallel>] [<preview.ppm>]" << std::endl;
         return 1;
     }
 
     const std::string input_filename = argv[1];
     const std::string output_filename = argv[2];
+    const int neighbors = (argc >= 4) ? std::stoi(argv[3]) : 4;
+    if (neighbors != 4 && neighbors != 8) {
+        std::cerr << "Connectivity must be 4 or 8." << std::endl;
+        return 1;
+    }
+    const std::string method_name = (argc >= 5) ? argv[4] : "twopass";
+    LabelingMethod method;
+    if (method_name == "twopass") {
+        method = LabelingMethod::kTwoPass;
+    } else if (method_name == "runs") {
+        method = LabelingMethod::kRuns;
+    } else if (method_name == "parallel") {
+        method = LabelingMethod::kParallel;
+    } else {
+        std::cerr << "Method must be twopass, runs or parallel." << std::endl;
+        return 1;
+    }
 
     Image binary_image;
     if (!ReadImage(input_filename, &binary_image)) {
@@ -101,14 +80,27 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    Image labeled_image;
-    SegmentImage(binary_image, labeled_image);
+    vector<int> labels;
+    const int num_objects = SegmentImage(binary_image, labels,
+                                         neighbors == 8 ? Connectivity::kEight : Connectivity::kFour,
+                                         method);
+    std::cout << num_objects << " objects found." << std::endl;
 
-    if (!WriteImage(output_filename, labeled_image)) {
+    const size_t rows = binary_image.num_rows();
+    const size_t cols = binary_image.num_columns();
+    if (!WriteLabelMap(output_filename, labels, rows, cols)) {
         std::cerr << "Error writing labeled image." << std::endl;
         return 1;
     }
-
     std::cout << "Labeled image saved as: " << output_filename << std::endl;
+
+    if (argc == 6) {
+        const std::string preview_filename = argv[5];
+        if (!WriteLabelPreview(preview_filename, labels, rows, cols)) {
+            std::cerr << "Error writing preview image." << std::endl;
+            return 1;
+        }
+        std::cout << "Preview image saved as: " << preview_filename << std::endl;
+    }
     return 0;
 }
@@ -0,0 +1,142 @@
+/*
+Name: Kevin Fang
+File: p4.cc
+Description:
+    The program, p4.cc, recognizes objects in a labeled image.
+    It takes a labeled image and a database of object descriptions
+    (an object_descriptions.txt file written by p3) as input, computes the attributes
+    of every object of the labeled image, and compares them with the database.
+    The output image shows only the recognized objects (in gray), with their positions and
+    orientations drawn as in p3: a dot for the position and a short line segment
+    originating from the dot for the orientation.
+
+    Objects are compared with features that don't change when an object is moved, rotated
+    or scaled: roundedness, Hu's first moment invariant and compactness. The compactness
+    uses a perimeter estimated from the pixel sides and corners of the boundary, which stays
+    within a few percent of the true length at any rotation (a count of pixel sides alone
+    grows by up to 41% when an object turns by 45 degrees).
+    The database is indexed with a k-d tree (object_recognition.cc), so every object is
+    matched in logarithmic time even against thousands of reference objects.
+
+To run this program after compiling with the makefile (make all):
+    ./p4 <input_labeled_image.pgm> <input_object_descriptions.txt> <output_image.pgm> [<roundedness tolerance> <relative tolerance> [<compactness tolerance>]]
+    Ex: ./p4 many_objects_1_labeled.pgm object_descriptions.txt output_image.pgm
+*/
+#include <algorithm>
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include "image.h"
+#include "label_map.h"
+#include "object_recognition.h"
+#include "region_properties.h"
+
+using namespace std;
+using namespace ComputerVisionProjects;
+
+#define M_PI 3.14159265358979323846
+
+// Function to recognize the objects of the labeled image and draw the recognized ones
+// Returns the number of recognized objects
+int RecognizeObjects(const vector<int> &labels, int rows, int cols, const vector<ObjectDescriptor> &database,
+                     const ObjectRecognizer &recognizer, Image &output_image) {
+    vector<RegionProperties> regions;
+    ComputeRegionProperties(labels, rows, cols, &regions);
+
+    output_image.AllocateSpaceAndSetSize(rows, cols);
+    output_image.SetNumberGrayLevels(255);
+
+    // matched[label] is true for the objects that are recognized
+    vector<char> matched(regions.size(), 0);
+    vector<ObjectDescriptor> recognized;
+    for (const RegionProperties &region : regions) {
+        if (region.label == 0 || region.area == 0) continue;
+        const ObjectDescriptor object = DescribeRegion(region);
+        double distance;
+        const int match = recognizer.Match(object, &distance);
+        if (match < 0) continue;
+
+        cout << "Object " << object.label << " matches database object " << database[match].label
+             << " (distance " << distance << ")" << endl;
+        matched[object.label] = 1;
+        recognized.push_back(object);
+    }
+
+    // Recognized objects in gray
+    for (int i = 0; i < rows; ++i) {
+        for (int j = 0; j < cols; ++j) {
+            output_image.SetPixel(i, j, matched[labels[i * cols + j]] ? 128 : 0);
+        }
+    }
+
+    for (const auto &object : recognized) {
+        const int center_row = static_cast<int>(object.center_row);
+        const int center_col = static_cast<int>(object.center_column);
+
+        // Orientation line, then a white dot at the center position
+        int line_length = 10; // Length of the orientation line
+        int end_row = static_cast<int>(object.center_row + line_length * cos(object.orientation * M_PI / 180.0));
+        int end_col = static_cast<int>(object.center_column + line_length * sin(object.orientation * M_PI / 180.0));
+        // SetPixel() aborts outside the image, so keep the segment inside it
+        end_row = min(max(end_row, 0), rows - 1);
+        end_col = min(max(end_col, 0), cols - 1);
+        DrawLine(center_row, center_col, end_row, end_col, 255, &output_image);
+        output_image.SetPixel(center_row, center_col, 255);
+    }
+    return recognized.size();
+}
+
+// Main function
+int main(int argc, char* argv[]) {
+    if (argc != 4 && argc != 6 && argc != 7) {
+        cerr << "Usage: " << argv[0] << " <input_labeled_image.pgm> <input_object_descriptions.txt> <output_image.pgm>"
+             << " [<roundedness tolerance> <relative tolerance> [<compactness tolerance>]]" << endl;
+        return 1;
+    }
+
+    const string input_filename = argv[1];
+    const string database_filename = argv[2];
+    const string output_image_filename = argv[3];
+
+    RecognitionOptions options;
+    if (argc >= 6) {
+        options.roundedness_tolerance = atof(argv[4]);
+        options.relative_tolerance = atof(argv[5]);
+        if (argc == 7) options.compactness_tolerance = atof(argv[6]);
+        if (options.roundedness_tolerance <= 0 || options.relative_tolerance <= 0 ||
+            options.compactness_tolerance <= 0) {
+            cerr << "Tolerances must be positive." << endl;
+            return 1;
+        }
+    }
+
+    vector<ObjectDescriptor> database;
+    if (!ReadObjectDescriptors(database_filename, &database)) {
+        cerr << "Error reading object descriptions." << endl;
+        return 1;
+    }
+    ObjectRecognizer recognizer;
+    if (!recognizer.Build(database, options)) {
+        cerr << "Error indexing object descriptions." << endl;
+        return 1;
+    }
+
+    vector<int> labels;
+    size_t rows, cols;
+    if (!ReadLabelMap(input_filename, &labels, &rows, &cols)) {
+        cerr << "Error reading labeled image." << endl;
+        return 1;
+    }
+
+    Image output_image;
+    const int num_recognized = RecognizeObjects(labels, rows, cols, database, recognizer, output_image);
+
+    if (!WriteImage(output_image_filename, output_image)) {
+        cerr << "Error writing output image." << endl;
+        return 1;
+    }
+
+    cout << num_recognized << " objects recognized." << endl;
+    cout << "Output image saved as: " << output_image_filename << endl;
+    return 0;
+}
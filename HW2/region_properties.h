@@ -0,0 +1,127 @@
+// Name: Kevin Fang
+// Region properties (area, moments, bounding box, perimeter) of every
+// object of a label image, accumulated in a single raster pass, and
+// the object descriptors p3 derives from them.
+
+#ifndef COMPUTER_VISION_REGION_PROPERTIES_H_
+#define COMPUTER_VISION_REGION_PROPERTIES_H_
+
+#include <cstdlib>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ComputerVisionProjects {
+
+// Properties of one object. The second moments are central moments
+// (sums of squared distances to the center), updated incrementally so
+// they stay accurate even for large objects far from the origin.
+struct RegionProperties {
+  int label = 0;
+  int area = 0;
+  double center_row = 0;
+  double center_column = 0;
+  // Sum of (row - center_row)^2, (row - center_row) * (column -
+  // center_column) and (column - center_column)^2 over the object.
+  double central_row_row = 0;
+  double central_row_column = 0;
+  double central_column_column = 0;
+  int min_row = 0;
+  int max_row = 0;
+  int min_column = 0;
+  int max_column = 0;
+  // Number of pixel sides between the object and anything that is not
+  // the object (background, other objects or the image border).
+  int perimeter = 0;
+  // Number of corners of that boundary, as BoundaryCorners() counts them
+  // at every grid point between pixels.
+  int corners = 0;
+
+  // Adds one pixel to the object.
+  void Add(int row, int column);
+
+  // Length of the boundary estimated from the sides and corners. The
+  // side count alone is the length of a staircase, which depends on the
+  // orientation of the object (a square turned by 45 degrees has sqrt(2)
+  // times the sides of an upright one); weighting out the corners keeps
+  // the estimate within about 5% of the true length of a straight edge
+  // at any angle.
+  double EstimatedPerimeter() const;
+
+  // Adds all pixels of another part of the same object.
+  void Merge(const RegionProperties &other);
+};
+
+// Corners of an object's boundary at the grid point shared by four
+// pixels, given which of them belong to the object in mask (bits 1, 2, 4
+// and 8 for the top left, top right, bottom left and bottom right
+// pixel): 1 for one or three pixels, 2 for two diagonal ones and 0
+// otherwise. The count of two 4-connected parts together is the sum of
+// their counts, so it can be accumulated and merged like the area.
+int BoundaryCorners(int mask);
+
+// Adds the boundary corners at the grid point between four pixels,
+// given by their labels (0 is background), to each object among them.
+// region(label) returns the RegionProperties to add to.
+template <typename RegionOf>
+void AddBoundaryCorners(int top_left, int top_right, int bottom_left, int bottom_right,
+                        RegionOf region) {
+  const int labels[4] = {top_left, top_right, bottom_left, bottom_right};
+  for (int k = 0; k < 4; ++k) {
+    const int label = labels[k];
+    if (label == 0 || (k > 0 && label == labels[0]) || (k > 1 && label == labels[1]) ||
+        (k > 2 && label == labels[2]))
+      continue;
+    const int mask = (top_left == label) | (top_right == label) << 1 |
+                     (bottom_left == label) << 2 | (bottom_right == label) << 3;
+    region(label).corners += BoundaryCorners(mask);
+  }
+}
+
+// Computes the properties of every label of a label image (num_rows x
+// num_columns, row-major) in one pass over the pixels. On return
+// (*regions)[label] holds the properties of that label, for every label
+// from 0 (background, not computed) to the largest one; labels that
+// don't occur have area 0. Returns the largest label.
+int ComputeRegionProperties(const std::vector<int> &labels, size_t num_rows,
+                            size_t num_columns,
+                            std::vector<RegionProperties> *regions);
+
+// The values p3 writes for each object.
+struct ObjectDescriptor {
+  int label = 0;
+  double center_row = 0;
+  double center_column = 0;
+  // Minimum moment of inertia per unit area.
+  double e_min = 0;
+  int area = 0;
+  // E_min / E_max.
+  double roundedness = 0;
+  // Angle of the axis of least inertia, in degrees.
+  double orientation = 0;
+  // Hu's first two moment invariants (eta20 + eta02 and
+  // (eta20 - eta02)^2 + 4 eta11^2), unchanged by rotation and scaling.
+  double hu1 = 0;
+  double hu2 = 0;
+  // EstimatedPerimeter()^2 / (4 pi area): about 1 for a disc, larger
+  // for elongated or ragged shapes, and nearly the same at any rotation.
+  double compactness = 0;
+};
+
+ObjectDescriptor DescribeRegion(const RegionProperties &region);
+
+// Writes the descriptor as one line of object_descriptions.txt:
+// label, center row, center column, E_min, area, roundedness,
+// orientation, hu1, hu2 and compactness, separated by blanks.
+void WriteObjectDescriptor(std::ostream &out, const ObjectDescriptor &descriptor);
+
+// Reads every line of an object_descriptions.txt file. Files written
+// before hu1, hu2 and compactness were added (seven values per line)
+// are read with those three values set to -1.
+// Returns true if everything is OK, false otherwise.
+bool ReadObjectDescriptors(const std::string &filename,
+                           std::vector<ObjectDescriptor> *descriptors);
+
+}  // namespace ComputerVisionProjects
+
+#endif  // COMPUTER_VISION_REGION_PROPERTIES_H_
@@ -0,0 +1,78 @@
+/*
+Name: Kevin Fang
+File: separate_objects.cc
+Description:
+    The program, separate_objects.cc, labels a binary image like p2, but also splits objects
+    that touch each other, which p2 merges into a single label.
+    Each object is split at its narrow necks with a marker-based watershed (watershed.cc):
+    the markers are the maxima of the distance transform of the binary image that are at
+    least <marker depth> pixels deeper than the neck joining them to another maximum,
+    and the inverted distance transform is flooded from them with a bucket queue.
+    The output is a labeled image (label map) that can be given to p3 like the output of p2.
+
+To run this program after compiling with the makefile (make all):
+    ./separate_objects <input_binary_image.pgm> <labeled_image.pgm> [<marker depth>] [<connectivity 4|8>] [<preview.ppm>]
+    Ex: ./separate_objects binary_two_objects.pgm labeled_two_objects.pgm 5 4 preview.ppm
+*/
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "connected_components.h"
+#include "image.h"
+#include "label_map.h"
+#include "watershed.h"
+
+using namespace std;
+using namespace ComputerVisionProjects;
+
+int main(int argc, char* argv[]) {
+    if (argc < 3 || argc > 6) {
+        cerr << "Usage: " << argv[0] << " <input_binary_image.pgm> <labeled_image.pgm>"
+             << " [<marker depth>] [<connectivity 4|8>] [<preview.ppm>]" << endl;
+        return 1;
+    }
+
+    const string input_filename = argv[1];
+    const string output_filename = argv[2];
+    // Maxima less than this many pixels above their neck are not split off
+    const double marker_depth = (argc > 3) ? atof(argv[3]) : 5.0;
+
+    Connectivity connectivity = Connectivity::kFour;
+    if (argc > 4) {
+        const string value(argv[4]);
+        if (value == "8") {
+            connectivity = Connectivity::kEight;
+        } else if (value != "4") {
+            cerr << "Connectivity must be 4 or 8" << endl;
+            return 1;
+        }
+    }
+
+    Image binary_image;
+    if (!ReadImage(input_filename, &binary_image)) {
+        cerr << "Error reading image." << endl;
+        return 1;
+    }
+    const size_t rows = binary_image.num_rows();
+    const size_t cols = binary_image.num_columns();
+
+    vector<unsigned char> mask;
+    ImageToMask(binary_image, &mask);
+
+    vector<int> labels;
+    const int num_objects = SeparateObjects(mask, rows, cols, marker_depth, connectivity, &labels);
+
+    if (!WriteLabelMap(output_filename, labels, rows, cols)) {
+        cerr << "Error writing labeled image." << endl;
+        return 1;
+    }
+    if (argc > 5 && !WriteLabelPreview(argv[5], labels, rows, cols)) {
+        cerr << "Error writing preview image." << endl;
+        return 1;
+    }
+
+    cout << num_objects << " objects found." << endl;
+    cout << "Labeled image saved as: " << output_filename << endl;
+    return 0;
+}
@@ -0,0 +1,117 @@
+/*
+Name: Kevin Fang
+File: stream_descriptors.cc
+Description:
+    The program, stream_descriptors.cc, computes the same object descriptions as p3
+    directly from a binary image, without building a labeled image first.
+    The image is read one row at a time and labeled with a streaming labeler
+    (streaming_labeler.cc) that only keeps the previous and the current row of labels
+    plus the objects that are still open, so line-scan images of any height can be
+    processed with memory proportional to the image width.
+    Each object's line (label, row and column position of the center, Emin, area,
+    roundedness and orientation, as in p3) is written as soon as the object is finished,
+    so the objects are numbered in the order in which they end rather than in raster order.
+
+To run this program after compiling with the makefile (make all):
+    ./stream_descriptors <input_binary_image.pgm> <output_object_descriptions.txt> [<connectivity 4|8>]
+    Ex: ./stream_descriptors binary_output.pgm object_descriptions.txt 8
+*/
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "streaming_labeler.h"
+
+using namespace std;
+using namespace ComputerVisionProjects;
+
+// Reads the next header line that is not a comment
+bool ReadHeaderLine(FILE *input, char *line, int size) {
+    do {
+        if (fgets(line, size, input) == nullptr) return false;
+    } while (*line == '#');
+    return true;
+}
+
+// Opens a binary pgm image and reads its header, leaving the file at the first row
+FILE *OpenPgm(const string &filename, int &rows, int &cols) {
+    FILE *input = fopen(filename.c_str(), "rb");
+    if (input == nullptr) {
+        cout << "Cannot open file: " << filename << endl;
+        return nullptr;
+    }
+    char line[1024];
+    int levels = 0;
+    if (fgets(line, sizeof line, input) == nullptr || strcmp(line, "P5\n") != 0 ||
+        !ReadHeaderLine(input, line, sizeof line) || sscanf(line, "%d %d", &cols, &rows) != 2 ||
+        !ReadHeaderLine(input, line, sizeof line) || sscanf(line, "%d", &levels) != 1 ||
+        levels > 255) {
+        cout << "Expected an 8-bit binary .pgm image: " << filename << endl;
+        fclose(input);
+        return nullptr;
+    }
+    return input;
+}
+
+int main(int argc, char **argv) {
+    if (argc != 3 && argc != 4) {
+        printf("Usage: %s <input_binary_image.pgm> <output_object_descriptions.txt> [<connectivity 4|8>]\n", argv[0]);
+        return 0;
+    }
+    const string input_file(argv[1]);
+    const string output_file(argv[2]);
+
+    Connectivity connectivity = Connectivity::kFour;
+    if (argc == 4) {
+        const string value(argv[3]);
+        if (value == "8") {
+            connectivity = Connectivity::kEight;
+        } else if (value != "4") {
+            cout << "Connectivity must be 4 or 8" << endl;
+            return 0;
+        }
+    }
+
+    int rows = 0, cols = 0;
+    FILE *input = OpenPgm(input_file, rows, cols);
+    if (input == nullptr) return 0;
+
+    ofstream out(output_file);
+    if (!out.is_open()) {
+        cerr << "Error opening output file: " << output_file << endl;
+        fclose(input);
+        return 0;
+    }
+
+    StreamingLabeler labeler(cols, connectivity);
+    vector<unsigned char> row(cols);
+    vector<RegionProperties> finished;
+    int num_objects = 0;
+    size_t most_live_objects = 0;
+
+    for (int i = 0; i < rows; ++i) {
+        if (fread(row.data(), 1, row.size(), input) != row.size()) {
+            cout << "Image ends after " << i << " rows" << endl;
+            break;
+        }
+        labeler.PushRow(row.data(), &finished);
+        most_live_objects = max(most_live_objects, labeler.live_objects());
+        for (const RegionProperties &object : finished) {
+            WriteObjectDescriptor(out, DescribeRegion(object));
+        }
+        num_objects += finished.size();
+        finished.clear();
+    }
+    labeler.Finish(&finished);
+    for (const RegionProperties &object : finished) {
+        WriteObjectDescriptor(out, DescribeRegion(object));
+    }
+    num_objects += finished.size();
+
+    fclose(input);
+    out.close();
+    cout << num_objects << " objects found (at most " << most_live_objects << " open at once)." << endl;
+    return 0;
+}
@@ -0,0 +1,158 @@
+// Name: Kevin Fang
+// Connected components labeling of a binary image that arrives one row
+// at a time (line-scan input). Only the previous and the current row of
+// labels are kept, together with the properties of the objects that are
+// still open, so memory depends on the image width and the number of
+// live objects but not on the image height.
+
+#include "streaming_labeler.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace ComputerVisionProjects {
+
+StreamingLabeler::StreamingLabeler(size_t num_columns, Connectivity connectivity)
+    : num_columns_{num_columns}, connectivity_{connectivity},
+      row_index_{0}, objects_emitted_{0},
+      previous_(num_columns, 0), current_(num_columns, 0),
+      parent_(1, 0), properties_(1), seen_(1, 0) { }
+
+int StreamingLabeler::NewLabel() {
+  int label;
+  if (!free_labels_.empty()) {
+    label = free_labels_.back();
+    free_labels_.pop_back();
+  } else {
+    label = parent_.size();
+    parent_.push_back(0);
+    properties_.emplace_back();
+    seen_.push_back(0);
+  }
+  parent_[label] = label;
+  properties_[label] = RegionProperties();
+  active_.push_back(label);
+  return label;
+}
+
+int StreamingLabeler::Find(int label) {
+  int root = label;
+  while (parent_[root] != root) root = parent_[root];
+  while (parent_[label] != root) {
+    const int next = parent_[label];
+    parent_[label] = root;
+    label = next;
+  }
+  return root;
+}
+
+void StreamingLabeler::Union(int label1, int label2) {
+  int root1 = Find(label1);
+  int root2 = Find(label2);
+  if (root1 == root2) return;
+  // The larger part absorbs the smaller one.
+  if (properties_[root1].area < properties_[root2].area) swap(root1, root2);
+  parent_[root2] = root1;
+  properties_[root1].Merge(properties_[root2]);
+}
+
+void StreamingLabeler::Emit(int root, vector<RegionProperties> *finished) {
+  RegionProperties object = properties_[root];
+  object.label = ++objects_emitted_;
+  finished->push_back(object);
+}
+
+void StreamingLabeler::PushRow(const unsigned char *mask_row,
+                               vector<RegionProperties> *finished) {
+  if (finished == nullptr) abort();
+  const int cols = num_columns_;
+  const bool first_row = (row_index_ == 0);
+  const bool eight = (connectivity_ == Connectivity::kEight);
+  previous_.swap(current_);
+  fill(current_.begin(), current_.end(), 0);
+
+  for (int j = 0; j < cols; ++j) {
+    const int above = previous_[j];
+    if (!mask_row[j]) {
+      // The pixel above ends here: its bottom side is on the boundary.
+      if (above != 0) ++properties_[Find(above)].perimeter;
+      continue;
+    }
+
+    int label = (j > 0) ? current_[j - 1] : 0;
+    auto visit = [&](int neighbor) {
+      if (neighbor == 0) return;
+      if (label == 0) label = neighbor;
+      else if (neighbor != label) Union(label, neighbor);
+    };
+    visit(above);
+    if (eight) {
+      if (j > 0) visit(previous_[j - 1]);
+      if (j + 1 < cols) visit(previous_[j + 1]);
+    }
+    if (label == 0) label = NewLabel();
+    current_[j] = label;
+
+    RegionProperties &object = properties_[Find(label)];
+    object.Add(row_index_, j);
+    if (j == 0 || !mask_row[j - 1]) ++object.perimeter;
+    if (j == cols - 1 || !mask_row[j + 1]) ++object.perimeter;
+    if (first_row || above == 0) ++object.perimeter;
+  }
+
+  // The grid points between the previous and this row, once the row's
+  // unions are done (the previous row is all 0 above the first row).
+  auto root = [&](const vector<int> &row, int j) {
+    return (j >= 0 && j < cols && row[j] != 0) ? Find(row[j]) : 0;
+  };
+  auto region = [&](int label) -> RegionProperties & { return properties_[label]; };
+  for (int j = 0; j <= cols; ++j) {
+    AddBoundaryCorners(root(previous_, j - 1), root(previous_, j), root(current_, j - 1),
+                       root(current_, j), region);
+  }
+
+  // Only roots stay in the current row, so every other label can be
+  // recycled, and a root that no pixel of this row refers to is closed.
+  for (int j = 0; j < cols; ++j) {
+    if (current_[j] == 0) continue;
+    current_[j] = Find(current_[j]);
+    seen_[current_[j]] = 1;
+  }
+  size_t kept = 0;
+  for (size_t k = 0; k < active_.size(); ++k) {
+    const int label = active_[k];
+    if (Find(label) == label && seen_[label]) {
+      seen_[label] = 0;
+      active_[kept++] = label;
+      continue;
+    }
+    if (Find(label) == label) Emit(label, finished);
+    free_labels_.push_back(label);
+  }
+  active_.resize(kept);
+  ++row_index_;
+}
+
+void StreamingLabeler::Finish(vector<RegionProperties> *finished) {
+  if (finished == nullptr) abort();
+  // The last row lies on the image border.
+  const int cols = num_columns_;
+  for (int j = 0; j < cols; ++j)
+    if (current_[j] != 0) ++properties_[current_[j]].perimeter;
+  auto region = [&](int label) -> RegionProperties & { return properties_[label]; };
+  for (int j = 0; j <= cols; ++j) {
+    AddBoundaryCorners(j > 0 ? current_[j - 1] : 0, j < cols ? current_[j] : 0, 0, 0, region);
+  }
+
+  for (int label : active_) {
+    Emit(label, finished);
+    free_labels_.push_back(label);
+  }
+  active_.clear();
+  fill(current_.begin(), current_.end(), 0);
+  fill(previous_.begin(), previous_.end(), 0);
+  row_index_ = 0;
+}
+
+}  // namespace ComputerVisionProjects
@@ -0,0 +1,69 @@
+// Name: Kevin Fang
+// Connected components labeling of a binary image that arrives one row
+// at a time (line-scan input). Only the previous and the current row of
+// labels are kept, together with the properties of the objects that are
+// still open, so memory depends on the image width and the number of
+// live objects but not on the image height.
+
+#ifndef COMPUTER_VISION_STREAMING_LABELER_H_
+#define COMPUTER_VISION_STREAMING_LABELER_H_
+
+#include <cstdlib>
+#include <vector>
+
+#include "connected_components.h"
+#include "region_properties.h"
+
+namespace ComputerVisionProjects {
+
+// Sample usage:
+//   StreamingLabeler labeler(num_columns, Connectivity::kFour);
+//   std::vector<RegionProperties> finished;
+//   while (more rows) {
+//     labeler.PushRow(row, &finished);
+//     for (const RegionProperties &object : finished) ...
+//     finished.clear();
+//   }
+//   labeler.Finish(&finished);
+// Objects are reported as soon as a row no longer touches them and are
+// numbered 1, 2, 3, ... in that order.
+class StreamingLabeler {
+ public:
+  StreamingLabeler(size_t num_columns, Connectivity connectivity);
+
+  // Labels the next row (num_columns values, non-zero is foreground) and
+  // appends every object that ended in the previous row to finished.
+  void PushRow(const unsigned char *mask_row, std::vector<RegionProperties> *finished);
+
+  // Ends the image and appends all objects that are still open.
+  void Finish(std::vector<RegionProperties> *finished);
+
+  // Number of objects that are still open.
+  size_t live_objects() const { return active_.size(); }
+
+ private:
+  int NewLabel();
+  int Find(int label);
+  void Union(int label1, int label2);
+  void Emit(int root, std::vector<RegionProperties> *finished);
+
+  size_t num_columns_;
+  Connectivity connectivity_;
+  int row_index_;
+  int objects_emitted_;
+  // Labels of the previous and the current row (0 is background).
+  std::vector<int> previous_;
+  std::vector<int> current_;
+  // Union-find over the labels in use; the properties of an object are
+  // kept at its root.
+  std::vector<int> parent_;
+  std::vector<RegionProperties> properties_;
+  std::vector<char> seen_;
+  // Labels in use and labels that can be handed out again.
+  std::vector<int> active_;
+  std::vector<int> free_labels_;
+};
+
+}  // namespace ComputerVisionProjects
+
+#endif  // COMPUTER_VISION_STREAMING_LABELER_H_
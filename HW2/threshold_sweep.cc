@@ -0,0 +1,120 @@
+/*
+Name: Kevin Fang
+File: threshold_sweep.cc
+Description:
+    The program, threshold_sweep.cc, finds the objects of a gray-level image at a whole range
+    of thresholds, as if p1, p2 and p3 were run once per threshold, to help choose the
+    threshold for a part type.
+    The image is scanned only once: its max-tree (max_tree.cc), the tree of the connected
+    components of the pixels above every gray-level, is built from the pixels sorted by
+    intensity with a union-find, together with the area, moments and perimeter of every
+    component. The objects at each threshold (pixels brighter than it, as in p1) are then
+    read off the tree.
+    For every threshold the output file has a line "threshold <t> objects <N>" followed by
+    one line per object with at least <min area> pixels, in the format of p3 (the label is
+    the index of the object's tree node, so the same object keeps its label over the
+    thresholds where it doesn't change).
+    Optionally the labeled image (label map) at one threshold is written as well; it is the
+    same as the output of p1 followed by p2 with that threshold and connectivity.
+
+To run this program after compiling with the makefile (make all):
+    ./threshold_sweep <input_image.pgm> <output_sweep.txt> <first>:<last>[:<step>] [<min area>] [<connectivity 4|8>] [<threshold> <labeled_image.pgm>]
+    Ex: ./threshold_sweep two_objects.pgm sweep.txt 64:192:8
+    Ex: ./threshold_sweep two_objects.pgm sweep.txt 64:192:8 20 8 128 labeled_two_objects.pgm
+*/
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "image.h"
+#include "label_map.h"
+#include "max_tree.h"
+
+using namespace std;
+using namespace ComputerVisionProjects;
+
+// Parses "64:192" or "64:192:8" (first, last and step of the thresholds)
+bool ParseRange(const string &text, int &first, int &last, int &step) {
+    step = 1;
+    const int count = sscanf(text.c_str(), "%d:%d:%d", &first, &last, &step);
+    return (count == 2 || count == 3) && step > 0 && first <= last;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 4 || argc > 8 || argc == 7) {
+        cerr << "Usage: " << argv[0] << " <input_image.pgm> <output_sweep.txt>"
+             << " <first>:<last>[:<step>] [<min area>] [<connectivity 4|8>]"
+             << " [<threshold> <labeled_image.pgm>]" << endl;
+        return 1;
+    }
+
+    const string input_filename = argv[1];
+    const string output_filename = argv[2];
+    int first, last, step;
+    if (!ParseRange(argv[3], first, last, step)) {
+        cerr << "Thresholds must be <first>:<last>[:<step>] with first <= last and step > 0" << endl;
+        return 1;
+    }
+    const int min_area = (argc > 4) ? atoi(argv[4]) : 0;
+
+    Connectivity connectivity = Connectivity::kFour;
+    if (argc > 5) {
+        const string value(argv[5]);
+        if (value == "8") {
+            connectivity = Connectivity::kEight;
+        } else if (value != "4") {
+            cerr << "Connectivity must be 4 or 8" << endl;
+            return 1;
+        }
+    }
+
+    Image input_image;
+    if (!ReadImage(input_filename, &input_image)) {
+        cerr << "Error reading image." << endl;
+        return 1;
+    }
+    const size_t rows = input_image.num_rows();
+    const size_t cols = input_image.num_columns();
+
+    vector<unsigned char> gray(rows * cols);
+    for (size_t i = 0; i < rows; ++i) {
+        for (size_t j = 0; j < cols; ++j) {
+            gray[i * cols + j] = input_image.GetPixel(i, j);
+        }
+    }
+
+    MaxTree tree;
+    tree.Build(gray, rows, cols, connectivity);
+
+    ofstream out(output_filename);
+    if (!out.is_open()) {
+        cerr << "Error opening output file: " << output_filename << endl;
+        return 1;
+    }
+    vector<RegionProperties> objects;
+    for (int threshold = first; threshold <= last; threshold += step) {
+        const int num_objects = tree.Components(threshold, min_area, &objects);
+        out << "threshold " << threshold << " objects " << num_objects << "\n";
+        for (const RegionProperties &object : objects) {
+            WriteObjectDescriptor(out, DescribeRegion(object));
+        }
+    }
+    out.close();
+    cout << tree.num_nodes() << " components in the tree." << endl;
+    cout << "Sweep saved as: " << output_filename << endl;
+
+    if (argc == 8) {
+        const string labeled_filename = argv[7];
+        vector<int> labels;
+        const int num_objects = tree.Label(atoi(argv[6]), &labels);
+        if (!WriteLabelMap(labeled_filename, labels, rows, cols)) {
+            cerr << "Error writing labeled image." << endl;
+            return 1;
+        }
+        cout << num_objects << " objects at threshold " << argv[6] << "." << endl;
+        cout << "Labeled image saved as: " << labeled_filename << endl;
+    }
+    return 0;
+}
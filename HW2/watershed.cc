@@ -0,0 +1,217 @@
+// Name: Kevin Fang
+// Marker-based watershed segmentation, used to split touching objects
+// of a binary mask that connected components labeling would merge.
+// Flooding uses a bucket queue (one FIFO per level), so the time is
+// linear in the number of pixels plus the number of levels.
+
+#include "watershed.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "distance_transform.h"
+
+using namespace std;
+
+namespace ComputerVisionProjects {
+
+namespace {
+
+// Priority queue of pixel indices for small integer priorities: one
+// FIFO per level and a pointer to the lowest non-empty one.
+class BucketQueue {
+ public:
+  explicit BucketQueue(int num_levels)
+      : buckets_(num_levels), heads_(num_levels, 0), lowest_{num_levels}, size_{0} { }
+
+  void Push(int level, int index) {
+    buckets_[level].push_back(index);
+    lowest_ = min(lowest_, level);
+    ++size_;
+  }
+
+  bool empty() const { return size_ == 0; }
+
+  // Removes the oldest index of the lowest level; level gets the level.
+  int Pop(int *level) {
+    while (heads_[lowest_] == buckets_[lowest_].size()) ++lowest_;
+    --size_;
+    *level = lowest_;
+    return buckets_[lowest_][heads_[lowest_]++];
+  }
+
+ private:
+  std::vector<std::vector<int>> buckets_;
+  std::vector<size_t> heads_;
+  int lowest_;
+  size_t size_;
+};
+
+// Calls visit(neighbor index) for the neighbors of pixel index inside
+// the image.
+template <typename Visit>
+inline void ForEachNeighbor(int index, int rows, int cols, Connectivity connectivity,
+                            Visit visit) {
+  static const int kRowSteps[8] = {0, -1, 0, 1, -1, -1, 1, 1};
+  static const int kColumnSteps[8] = {1, 0, -1, 0, 1, -1, -1, 1};
+  const int count = (connectivity == Connectivity::kEight) ? 8 : 4;
+  const int i = index / cols;
+  const int j = index % cols;
+  for (int k = 0; k < count; ++k) {
+    const int r = i + kRowSteps[k];
+    const int c = j + kColumnSteps[k];
+    if (r >= 0 && r < rows && c >= 0 && c < cols) visit(r * cols + c);
+  }
+}
+
+// Gives every unlabeled seed pixel a new label, starting at next_label,
+// and spreads it to the neighbors q of labeled pixels p for which
+// linked(p, q). Returns the next unused label.
+template <typename Seed, typename Linked>
+int LabelRemaining(int rows, int cols, Connectivity connectivity, Seed seed,
+                   Linked linked, int next_label, vector<int> *labels) {
+  vector<int> stack;
+  for (int index = 0; index < rows * cols; ++index) {
+    if (!seed(index) || (*labels)[index] != 0) continue;
+    (*labels)[index] = next_label;
+    stack.push_back(index);
+    while (!stack.empty()) {
+      const int p = stack.back();
+      stack.pop_back();
+      ForEachNeighbor(p, rows, cols, connectivity, [&](int q) {
+        if ((*labels)[q] == 0 && linked(p, q)) {
+          (*labels)[q] = next_label;
+          stack.push_back(q);
+        }
+      });
+    }
+    ++next_label;
+  }
+  return next_label;
+}
+
+}  // namespace
+
+int FindMaximaMarkers(const vector<int> &height, size_t num_rows, size_t num_columns,
+                      int depth, Connectivity connectivity, vector<int> *markers) {
+  if (markers == nullptr) abort();
+  const int rows = num_rows;
+  const int cols = num_columns;
+  const int n = rows * cols;
+  depth = max(depth, 1);
+  const int highest = n > 0 ? *max_element(height.begin(), height.end()) : 0;
+
+  // Reconstruction by dilation of height - depth under height, highest
+  // values first. Its regional maxima are the h-maxima: plateaus that
+  // contain a pixel where height - reconstruction is depth.
+  vector<int> reconstruction(n);
+  BucketQueue queue(highest + 1);
+  for (int index = 0; index < n; ++index) {
+    reconstruction[index] = max(height[index] - depth, 0);
+    queue.Push(highest - reconstruction[index], index);
+  }
+  while (!queue.empty()) {
+    int level;
+    const int p = queue.Pop(&level);
+    if (highest - reconstruction[p] != level) continue;  // Raised since pushed.
+    ForEachNeighbor(p, rows, cols, connectivity, [&](int q) {
+      const int value = min(reconstruction[p], height[q]);
+      if (value > reconstruction[q]) {
+        reconstruction[q] = value;
+        queue.Push(highest - value, q);
+      }
+    });
+  }
+
+  // Each marker is the plateau of the reconstruction around such a
+  // pixel. Ridges of a distance transform often run diagonally, so
+  // plateaus are grown with all 8 neighbors; with 4-connectivity a
+  // diagonal step must pass next to a non-zero pixel, so a marker never
+  // spans two objects that only touch at a corner.
+  markers->assign(n, 0);
+  auto is_top = [&](int index) {
+    return height[index] > 0 && height[index] - reconstruction[index] >= depth;
+  };
+  auto linked = [&](int p, int q) {
+    if (height[q] == 0 || reconstruction[q] != reconstruction[p]) return false;
+    if (connectivity == Connectivity::kEight || p / cols == q / cols || p % cols == q % cols)
+      return true;
+    return height[(p / cols) * cols + q % cols] > 0 || height[(q / cols) * cols + p % cols] > 0;
+  };
+  return LabelRemaining(rows, cols, Connectivity::kEight, is_top, linked, 1, markers) - 1;
+}
+
+int Watershed(const vector<int> &relief, int num_levels, const vector<int> &markers,
+              const vector<unsigned char> &mask, size_t num_rows, size_t num_columns,
+              Connectivity connectivity, vector<int> *labels) {
+  if (labels == nullptr) abort();
+  const int rows = num_rows;
+  const int cols = num_columns;
+  const int n = rows * cols;
+  labels->assign(n, 0);
+
+  // Priority flood: a pixel is labeled when it is first reached and
+  // queued at its own level, or at the current level if it is lower, so
+  // a basin spills over its lowest saddle first.
+  BucketQueue queue(num_levels);
+  int next_label = 1;
+  for (int index = 0; index < n; ++index) {
+    if (!mask[index] || markers[index] == 0) continue;
+    (*labels)[index] = markers[index];
+    next_label = max(next_label, markers[index] + 1);
+    queue.Push(relief[index], index);
+  }
+  while (!queue.empty()) {
+    int level;
+    const int p = queue.Pop(&level);
+    ForEachNeighbor(p, rows, cols, connectivity, [&](int q) {
+      if (!mask[q] || (*labels)[q] != 0) return;
+      (*labels)[q] = (*labels)[p];
+      queue.Push(max(relief[q], level), q);
+    });
+  }
+  LabelRemaining(rows, cols, connectivity, [&](int index) { return mask[index] != 0; },
+                 [&](int, int q) { return mask[q] != 0; }, next_label, labels);
+
+  // Renumber 1..N in raster order of first pixels.
+  vector<int> renumbered(next_label + 1, 0);
+  int count = 0;
+  for (int index = 0; index < n; ++index) {
+    int &label = (*labels)[index];
+    if (label == 0) continue;
+    if (label >= static_cast<int>(renumbered.size())) renumbered.resize(label + 1, 0);
+    if (renumbered[label] == 0) renumbered[label] = ++count;
+    label = renumbered[label];
+  }
+  return count;
+}
+
+int SeparateObjects(const vector<unsigned char> &mask, size_t num_rows, size_t num_columns,
+                    double marker_depth, Connectivity connectivity, vector<int> *labels) {
+  if (labels == nullptr) abort();
+  // Exact Euclidean distances, in quarter pixels so that the bucket
+  // queue levels stay integers.
+  const int kLevelsPerPixel = 4;
+  vector<int> squared_distances;
+  EuclideanDistanceTransform(mask, num_rows, num_columns, 0, &squared_distances);
+  vector<int> distances(squared_distances.size(), 0);
+  int largest = 0;
+  for (size_t k = 0; k < distances.size(); ++k) {
+    if (!mask[k]) continue;
+    distances[k] =
+        static_cast<int>(lround(sqrt(static_cast<double>(squared_distances[k])) * kLevelsPerPixel));
+    largest = max(largest, distances[k]);
+  }
+
+  vector<int> markers;
+  const int depth = static_cast<int>(lround(marker_depth * kLevelsPerPixel));
+  FindMaximaMarkers(distances, num_rows, num_columns, depth, connectivity, &markers);
+
+  // Basins are the distance maxima, so flood the inverted distances.
+  vector<int> relief(distances.size());
+  for (size_t k = 0; k < distances.size(); ++k) relief[k] = largest - distances[k];
+  return Watershed(relief, largest + 1, markers, mask, num_rows, num_columns, connectivity,
+                   labels);
+}
+
+}  // namespace ComputerVisionProjects
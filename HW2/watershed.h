@@ -0,0 +1,51 @@
+// Name: Kevin Fang
+// Marker-based watershed segmentation, used to split touching objects
+// of a binary mask that connected components labeling would merge.
+// Flooding uses a bucket queue (one FIFO per level), so the time is
+// linear in the number of pixels plus the number of levels.
+
+#ifndef COMPUTER_VISION_WATERSHED_H_
+#define COMPUTER_VISION_WATERSHED_H_
+
+#include <cstdlib>
+#include <vector>
+
+#include "connected_components.h"
+
+namespace ComputerVisionProjects {
+
+// Finds one marker per significant maximum of height (num_rows x
+// num_columns, values >= 0): the h-maxima, i.e. the maxima that rise at
+// least depth above the highest saddle linking them to a higher
+// maximum. Each marker covers the top depth of its maximum (8-connected;
+// with 4-connectivity diagonal pixels are grouped only through a
+// non-zero corner) and gets its own label (1, 2, ...) in markers; every
+// other pixel is 0. Returns the number of markers.
+int FindMaximaMarkers(const std::vector<int> &height, size_t num_rows,
+                      size_t num_columns, int depth, Connectivity connectivity,
+                      std::vector<int> *markers);
+
+// Floods relief (values 0..num_levels-1) from the markers, lowest level
+// first, restricted to the pixels where mask is non-zero. Every flooded
+// pixel takes the label of the basin that reaches it first; pixels of
+// equal level are taken in the order they are reached, so plateaus are
+// split halfway between markers. Mask pixels that no marker reaches
+// get new labels, one per connected piece. Background pixels get 0.
+// On return labels are 1..N in the raster order of each object's first
+// pixel, as p2 numbers them. Returns N.
+int Watershed(const std::vector<int> &relief, int num_levels,
+              const std::vector<int> &markers, const std::vector<unsigned char> &mask,
+              size_t num_rows, size_t num_columns, Connectivity connectivity,
+              std::vector<int> *labels);
+
+// Splits the touching objects of mask: markers are the maxima of the
+// Euclidean distance transform that are at least marker_depth pixels
+// deep, and the inverted distance transform is flooded from them.
+// Returns the number of objects.
+int SeparateObjects(const std::vector<unsigned char> &mask, size_t num_rows,
+                    size_t num_columns, double marker_depth, Connectivity connectivity,
+                    std::vector<int> *labels);
+
+}  // namespace ComputerVisionProjects
+
+#endif  // COMPUTER_VISION_WATERSHED_H_
@@ -6,27 +6,69 @@ Description:
     to detect lines and outputs a gray-level Hough space image and a Hough-voting
     array txt file.
 
+    When a vote threshold is given as a fourth argument, h3 runs in hierarchical
+    mode instead: it votes into a coarse 4-degree x 4-pixel accumulator, keeps the
+    peaks with at least that many votes (a positive number), and refines only their
+    neighborhoods at 0.25-degree x 1-pixel resolution using the edge points that
+    voted for them.
+    The Hough image is then the coarse accumulator and the txt file lists the
+    detected lines, one "rho theta votes" triple (theta in degrees) per line.
+
 Compile with:
-    g++ h3.cc image.cc -o h3
+    g++ h3.cc hough.cc image.cc -o h3
 
 To run this program after compiling:
     ./h3 <input binary edge image> <output gray-level Hough image> <output Hough-voting array txt file>
     Ex: ./h3 output_binary.pgm output_gray_hough.pgm output_array.txt
+
+    ./h3 <input binary edge image> <output gray-level Hough image> <output lines txt file> <vote threshold>
+    Ex: ./h3 output_binary.pgm output_coarse_hough.pgm output_lines.txt 600
 */
 #include "image.h"
+#include "hough.h"
 #include <iostream>
-#include <cmath>
 #include <fstream>
+#include <string>
 #include <vector>
 
 using namespace std;
 using namespace ComputerVisionProjects;
 
-#define M_PI 3.14159265358979323846
+// Hierarchical mode: writes the coarse accumulator and the refined lines.
+int RunHierarchical(const vector<EdgePoint> &points, const Image &edge_image, int threshold,
+                    const string &output_filename, const string &lines_filename) {
+    HierarchicalHoughOptions options;
+    options.threshold = threshold;
+
+    HoughAccumulator coarse;
+    vector<HoughLine> lines;
+    DetectLinesHierarchical(points, edge_image.num_rows(), edge_image.num_columns(),
+                            options, &lines, &coarse);
+
+    Image hough_image;
+    HoughToImage(coarse, &hough_image);
+    if (!WriteImage(output_filename, hough_image)) {
+        cerr << "Error writing Hough image.\n";
+        return 1;
+    }
+
+    ofstream lines_file(lines_filename);
+    if (!lines_file) {
+        cerr << "Error opening lines output file.\n";
+        return 1;
+    }
+    for (const HoughLine &line : lines) {
+        lines_file << line.rho << " " << line.theta << " " << line.votes << "\n";
+    }
+
+    cout << "Hierarchical Hough Transform found " << lines.size() << " lines. Output saved to "
+         << output_filename << " and " << lines_filename << ".\n";
+    return 0;
+}
 
 int main(int argc, char **argv) {
-    if (argc != 4) {
-        std::cout << "Usage: " << argv[0] << " {input binary edge image} {output gray-level Hough image} {output Hough-voting array}\n";
+    if (argc != 4 && argc != 5) {
+        std::cout << "Usage: " << argv[0] << " {input binary edge image} {output gray-level Hough image} {output Hough-voting array} [{vote threshold}]\n";
         return 0;
     }
 
@@ -40,49 +82,27 @@ int main(int argc, char **argv) {
         return 1;
     }
 
-    int width = edge_image.num_columns();
-    int height = edge_image.num_rows();
-    int max_rho = static_cast<int>(std::sqrt(width * width + height * height));
-    int theta_bins = 180;  // Dividing [0, π] into 180 bins (1-degree increments)
-    int rho_bins = max_rho * 2;
-
-    // Accumulator array for Hough votes
-    vector<vector<int>> accumulator(rho_bins, vector<int>(theta_bins, 0));
-
-    // Hough Transform: Vote in the accumulator array
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            if (edge_image.GetPixel(y, x) > 0) {  // If it's an edge point
-                for (int t = 0; t < theta_bins; ++t) {
-                    double theta = t * M_PI / theta_bins;
-                    int rho = static_cast<int>(x * cos(theta) + y * sin(theta)) + max_rho;
-                    if (rho >= 0 && rho < rho_bins) {
-                        accumulator[rho][t]++;
-                    }
-                }
-            }
+    // Edge points are collected once so that voting doesn't rescan the image
+    vector<EdgePoint> points;
+    CollectEdgePoints(edge_image, &points);
+
+    if (argc == 5) {
+        const int threshold = stoi(argv[4]);
+        if (threshold <= 0) {
+            cerr << "The vote threshold must be positive.\n";
+            return 1;
         }
+        return RunHierarchical(points, edge_image, threshold, output_filename, voting_array_filename);
     }
 
+    // Accumulator array for Hough votes, dividing [0, π] into 180 bins (1-degree increments)
+    HoughAccumulator accumulator;
+    accumulator.Reset(edge_image.num_rows(), edge_image.num_columns(), 1.0, 1.0);
+    accumulator.Vote(points);
+
     // Create the Hough image based on the accumulator array
     Image hough_image;
-    hough_image.AllocateSpaceAndSetSize(theta_bins, rho_bins);
-    hough_image.SetNumberGrayLevels(255);
-
-    int max_votes = 0;
-    for (int r = 0; r < rho_bins; ++r) {
-        for (int t = 0; t < theta_bins; ++t) {
-            max_votes = std::max(max_votes, accumulator[r][t]);
-        }
-    }
-
-    // Normalize and set pixel intensity in Hough space image
-    for (int r = 0; r < rho_bins; ++r) {
-        for (int t = 0; t < theta_bins; ++t) {
-            int intensity = static_cast<int>(255.0 * accumulator[r][t] / max_votes);
-            hough_image.SetPixel(t, r, intensity);
-        }
-    }
+    HoughToImage(accumulator, &hough_image);
 
     if (!WriteImage(output_filename, hough_image)) {
         cerr << "Error writing Hough image.\n";
@@ -95,9 +115,9 @@ int main(int argc, char **argv) {
         cerr << "Error opening voting array output file.\n";
         return 1;
     }
-    for (int r = 0; r < rho_bins; ++r) {
-        for (int t = 0; t < theta_bins; ++t) {
-            voting_array_file << accumulator[r][t] << " ";
+    for (int r = 0; r < accumulator.rho_bins(); ++r) {
+        for (int t = 0; t < accumulator.theta_bins(); ++t) {
+            voting_array_file << accumulator.votes(r, t) << " ";
         }
         voting_array_file << "\n";
     }
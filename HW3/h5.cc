@@ -0,0 +1,109 @@
+/*
+Name: Kevin Fang
+File: h5.cc
+Description:
+    The program, h5.cc, runs the whole line detection chain of h1.cc -> h2.cc -> h3.cc -> h4.cc
+    in a single process. The gray-level image is read once, and the edge image, binary edge image,
+    Hough-voting array and line parameters are handed from stage to stage in memory instead of
+    through output_gray_edge.pgm, output_binary.pgm, output_gray_hough.pgm and output_array.txt.
+
+    Any number of (input, output) image pairs can be given; the stage buffers are reused from
+    one frame to the next. The detected lines are drawn onto each input image the same way
+    h4.cc draws them.
+
+    Options (before the thresholds):
+        --stages        also writes the intermediate images of every frame next to its output
+                        (<output>_gray_edge.pgm, <output>_binary.pgm and <output>_hough.pgm)
+        --hierarchical  uses the coarse-to-fine Hough accumulator; the Hough threshold is then
+                        the coarse vote threshold (see h3.cc)
+
+Compile with:
+    g++ h5.cc line_detection.cc hough.cc image.cc -o h5
+
+To run this program after compiling:
+    ./h5 [--stages] [--hierarchical] <edge threshold> <Hough threshold> <input gray-level image> <output gray-level line image> [<input> <output> ...]
+    Ex: ./h5 50 290 hough_simple_1.pgm output_grayline.pgm
+*/
+#include "image.h"
+#include "line_detection.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace ComputerVisionProjects;
+
+// Strips the extension of a .pgm filename so stage images can be named after it
+string StageFilename(const string &output_filename, const string &stage) {
+    const size_t dot = output_filename.rfind('.');
+    const string base = (dot == string::npos) ? output_filename : output_filename.substr(0, dot);
+    return base + "_" + stage + ".pgm";
+}
+
+int main(int argc, char **argv) {
+    LineDetectionOptions options;
+    bool save_stages = false;
+
+    int arg = 1;
+    for (; arg < argc && string(argv[arg]).rfind("--", 0) == 0; ++arg) {
+        const string option(argv[arg]);
+        if (option == "--stages") {
+            save_stages = true;
+        } else if (option == "--hierarchical") {
+            options.hierarchical = true;
+        } else {
+            cerr << "Unknown option " << option << "\n";
+            return 1;
+        }
+    }
+
+    if (argc - arg < 4 || (argc - arg) % 2 != 0) {
+        std::cout << "Usage: " << argv[0] << " [--stages] [--hierarchical] {edge threshold} {Hough threshold} "
+                  << "{input gray-level image} {output gray-level line image} [{input} {output} ...]\n";
+        return 0;
+    }
+
+    options.edge_threshold = stoi(argv[arg]);
+    options.hough_threshold = stoi(argv[arg + 1]);
+
+    LineDetector detector;
+    vector<HoughLine> lines;
+    Image gray_edge, binary_edge, hough;
+    LineDetectionStages stages;
+    if (save_stages) {
+        stages.gray_edge = &gray_edge;
+        stages.binary_edge = &binary_edge;
+        stages.hough = &hough;
+    }
+
+    for (int i = arg + 2; i < argc; i += 2) {
+        const string input_filename(argv[i]);
+        const string output_filename(argv[i + 1]);
+
+        Image image;
+        if (!ReadImage(input_filename, &image)) {
+            cerr << "Error reading image " << input_filename << ".\n";
+            return 1;
+        }
+
+        detector.Detect(image, options, &lines, save_stages ? &stages : nullptr);
+
+        // Just change the number to adjust the gray-level color of the lines
+        DrawDetectedLines(lines, 100, &image);
+        if (!WriteImage(output_filename, image)) {
+            cerr << "Error writing output line image " << output_filename << ".\n";
+            return 1;
+        }
+
+        if (save_stages &&
+            (!WriteImage(StageFilename(output_filename, "gray_edge"), gray_edge) ||
+             !WriteImage(StageFilename(output_filename, "binary"), binary_edge) ||
+             !WriteImage(StageFilename(output_filename, "hough"), hough))) {
+            cerr << "Error writing stage images for " << output_filename << ".\n";
+            return 1;
+        }
+
+        cout << input_filename << ": " << lines.size() << " lines. Output saved to " << output_filename << ".\n";
+    }
+    return 0;
+}
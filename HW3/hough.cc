@@ -0,0 +1,299 @@
+// Name: Kevin Fang
+// Hough transform for straight lines. Supports the dense
+// 1-degree x 1-pixel voting array used by h3.cc/h4.cc and a
+// coarse-to-fine (hierarchical) mode that only refines the
+// neighborhoods of real peaks at fine resolution.
+
+#include "hough.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+using namespace std;
+
+namespace ComputerVisionProjects {
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+
+// Largest possible |rho| for an image of the given size.
+int MaxRho(size_t num_rows, size_t num_columns) {
+  const int width = num_columns;
+  const int height = num_rows;
+  return static_cast<int>(sqrt(width * width + height * height));
+}
+
+// True if cell (r, t) is a local maximum of its 3x3 neighborhood.
+// Ties are broken in raster order so that a plateau yields one peak.
+bool IsLocalMaximum(const HoughAccumulator &accumulator, int r, int t) {
+  const int value = accumulator.votes(r, t);
+  for (int dr = -1; dr <= 1; ++dr) {
+    for (int dt = -1; dt <= 1; ++dt) {
+      const int rr = r + dr;
+      const int tt = t + dt;
+      if ((dr == 0 && dt == 0) || rr < 0 || rr >= accumulator.rho_bins() ||
+          tt < 0 || tt >= accumulator.theta_bins()) continue;
+      const int neighbor = accumulator.votes(rr, tt);
+      const bool before = dr < 0 || (dr == 0 && dt < 0);
+      if (neighbor > value || (before && neighbor == value)) return false;
+    }
+  }
+  return true;
+}
+
+// Maps theta outside [0, 180) back into it; (rho, theta) and
+// (-rho, theta + 180) describe the same line.
+void NormalizeLine(HoughLine *line) {
+  while (line->theta < 0) {
+    line->theta += 180.0;
+    line->rho = -line->rho;
+  }
+  while (line->theta >= 180.0) {
+    line->theta -= 180.0;
+    line->rho = -line->rho;
+  }
+}
+
+// True if the two lines lie within the given tolerances of each other,
+// taking the wrap-around at theta = 0/180 into account.
+bool SameLine(const HoughLine &a, const HoughLine &b,
+              double theta_tolerance, double rho_tolerance) {
+  const double dtheta = fabs(a.theta - b.theta);
+  if (dtheta < theta_tolerance) return fabs(a.rho - b.rho) < rho_tolerance;
+  if (180.0 - dtheta < theta_tolerance) return fabs(a.rho + b.rho) < rho_tolerance;
+  return false;
+}
+
+// Re-votes points[0, count) in a small fine-resolution window around
+// (rho_center, theta_center) and sets line to the weighted center of the
+// strongest fine cell and its 3x3 neighborhood. Returns false, leaving
+// line unchanged, if no point votes inside the window.
+bool RefinePeak(const EdgePoint *points, size_t count, double theta_center,
+                double rho_center, double theta_half_width, double rho_half_width,
+                const HierarchicalHoughOptions &options, HoughLine *line) {
+  const int theta_bins =
+      2 * static_cast<int>(ceil(theta_half_width / options.fine_theta_step)) + 1;
+  const int rho_bins =
+      2 * static_cast<int>(ceil(rho_half_width / options.fine_rho_step)) + 1;
+  const double theta_start =
+      theta_center - (theta_bins / 2) * options.fine_theta_step;
+  const double rho_start = rho_center - (rho_bins / 2) * options.fine_rho_step;
+
+  // Votes are stored theta-major while voting, so each theta writes
+  // into one contiguous row.
+  const double inverse_rho_step = 1.0 / options.fine_rho_step;
+  vector<int> votes(rho_bins * theta_bins, 0);
+  for (int t = 0; t < theta_bins; ++t) {
+    int *theta_votes = votes.data() + t * rho_bins;
+    const double theta = (theta_start + t * options.fine_theta_step) * kPi / 180.0;
+    const double cos_theta = cos(theta);
+    const double sin_theta = sin(theta);
+    for (size_t k = 0; k < count; ++k) {
+      const double rho = points[k].x * cos_theta + points[k].y * sin_theta;
+      // Truncation rounds like floor() once negative bins are skipped,
+      // without a library call per point.
+      const double bin = (rho - rho_start) * inverse_rho_step + 0.5;
+      if (bin < 0) continue;
+      const int r = static_cast<int>(bin);
+      if (r < rho_bins) ++theta_votes[r];
+    }
+  }
+  auto cell = [&](int r, int t) { return votes[t * rho_bins + r]; };
+
+  // The first strongest cell in (rho, theta) raster order.
+  int best_r = 0, best_t = 0;
+  for (int r = 0; r < rho_bins; ++r)
+    for (int t = 0; t < theta_bins; ++t)
+      if (cell(r, t) > cell(best_r, best_t)) {
+        best_r = r;
+        best_t = t;
+      }
+
+  double weighted_r = 0, weighted_t = 0, total_weight = 0;
+  for (int dr = -1; dr <= 1; ++dr) {
+    for (int dt = -1; dt <= 1; ++dt) {
+      const int rr = best_r + dr;
+      const int tt = best_t + dt;
+      if (rr < 0 || rr >= rho_bins || tt < 0 || tt >= theta_bins) continue;
+      const double weight = cell(rr, tt);
+      weighted_r += rr * weight;
+      weighted_t += tt * weight;
+      total_weight += weight;
+    }
+  }
+
+  if (total_weight == 0) return false;
+  line->rho = rho_start + (weighted_r / total_weight) * options.fine_rho_step;
+  line->theta = theta_start + (weighted_t / total_weight) * options.fine_theta_step;
+  line->votes = cell(best_r, best_t);
+  NormalizeLine(line);
+  return true;
+}
+
+}  // namespace
+
+void CollectEdgePoints(const Image &edge_image, vector<EdgePoint> *points) {
+  if (points == nullptr) abort();
+  points->clear();
+  for (size_t y = 0; y < edge_image.num_rows(); ++y)
+    for (size_t x = 0; x < edge_image.num_columns(); ++x)
+      if (edge_image.GetPixel(y, x) > 0)
+        points->push_back({static_cast<int>(x), static_cast<int>(y)});
+}
+
+void HoughAccumulator::Reset(size_t num_rows, size_t num_columns,
+                             double theta_step, double rho_step) {
+  const int theta_bins = static_cast<int>(round(180.0 / theta_step));
+  const int rho_offset = static_cast<int>(ceil(MaxRho(num_rows, num_columns) / rho_step));
+  if (theta_bins == theta_bins_ && rho_offset == rho_offset_ &&
+      theta_step == theta_step_ && rho_step == rho_step_) {
+    // Same geometry as the previous frame: keep the tables and storage.
+    fill(votes_.begin(), votes_.end(), 0);
+    return;
+  }
+  theta_step_ = theta_step;
+  rho_step_ = rho_step;
+  theta_bins_ = theta_bins;
+  rho_offset_ = rho_offset;
+  rho_bins_ = rho_offset_ * 2;
+
+  cos_table_.resize(theta_bins_);
+  sin_table_.resize(theta_bins_);
+  for (int t = 0; t < theta_bins_; ++t) {
+    const double theta = t * theta_step * kPi / 180.0;
+    cos_table_[t] = cos(theta);
+    sin_table_[t] = sin(theta);
+  }
+  votes_.assign(static_cast<size_t>(rho_bins_) * theta_bins_, 0);
+}
+
+void HoughAccumulator::Vote(const vector<EdgePoint> &points) {
+  for (const EdgePoint &point : points) {
+    for (int t = 0; t < theta_bins_; ++t) {
+      const int r = RhoBin(point, t);
+      if (r >= 0 && r < rho_bins_) ++votes_[r * theta_bins_ + t];
+    }
+  }
+}
+
+int HoughAccumulator::MaxVotes() const {
+  if (votes_.empty()) return 0;
+  return *max_element(votes_.begin(), votes_.end());
+}
+
+void DetectLinesHierarchical(const vector<EdgePoint> &points,
+                             size_t num_rows, size_t num_columns,
+                             const HierarchicalHoughOptions &options,
+                             vector<HoughLine> *lines,
+                             HoughAccumulator *coarse) {
+  if (lines == nullptr) abort();
+  lines->clear();
+
+  HoughAccumulator local_accumulator;
+  HoughAccumulator &accumulator = coarse != nullptr ? *coarse : local_accumulator;
+  accumulator.Reset(num_rows, num_columns,
+                    options.coarse_theta_step, options.coarse_rho_step);
+  accumulator.Vote(points);
+
+  const int theta_bins = accumulator.theta_bins();
+  const int rho_bins = accumulator.rho_bins();
+  // A cell without votes is never a peak, whatever the threshold.
+  const int threshold = max(1, options.threshold);
+  vector<pair<int, int>> peaks;
+  vector<char> peak_columns(theta_bins, 0);
+  vector<char> needed(static_cast<size_t>(theta_bins) * rho_bins, 0);
+  for (int r = 0; r < rho_bins; ++r) {
+    for (int t = 0; t < theta_bins; ++t) {
+      if (accumulator.votes(r, t) < threshold || !IsLocalMaximum(accumulator, r, t)) continue;
+      peaks.push_back({r, t});
+      peak_columns[t] = 1;
+      for (int rr = max(0, r - 1); rr <= min(rho_bins - 1, r + 1); ++rr)
+        needed[t * rho_bins + rr] = 1;
+    }
+  }
+
+  // The points of the cells next to a peak, bucketed by cell
+  // theta-major, so that the rho neighbors r - 1..r + 1 of a column t
+  // are contiguous: cell (r, t) holds bucketed[first[t * rho_bins + r],
+  // first[t * rho_bins + r + 1]). The vote counts size the buckets, and
+  // only the columns with a peak are voted again.
+  vector<size_t> first(needed.size() + 1, 0);
+  for (int t = 0; t < theta_bins; ++t)
+    for (int r = 0; r < rho_bins; ++r)
+      first[t * rho_bins + r + 1] =
+          first[t * rho_bins + r] + (needed[t * rho_bins + r] ? accumulator.votes(r, t) : 0);
+  vector<EdgePoint> bucketed(first.back());
+  vector<size_t> next(first.begin(), first.end() - 1);
+  for (int t = 0; t < theta_bins; ++t) {
+    if (!peak_columns[t]) continue;
+    for (const EdgePoint &point : points) {
+      const int r = accumulator.RhoBin(point, t);
+      if (r >= 0 && r < rho_bins && needed[t * rho_bins + r])
+        bucketed[next[t * rho_bins + r]++] = point;
+    }
+  }
+
+  // The three rho cells around a peak reach 2.5 coarse steps from its
+  // center (bin 0 is two steps wide). Across one coarse theta bin the
+  // rho of a point moves by at most max_rho * sin(theta_step), so the
+  // fine window has to cover that too.
+  const double max_rho = MaxRho(num_rows, num_columns);
+  const double theta_half_width = options.coarse_theta_step;
+  const double rho_half_width =
+      2.5 * options.coarse_rho_step +
+      max_rho * sin(theta_half_width * kPi / 180.0) + options.fine_rho_step;
+
+  vector<HoughLine> candidates;
+  for (const pair<int, int> &peak : peaks) {
+    const int r = peak.first, t = peak.second;
+    // Only the points that voted into this cell or its rho neighbors
+    // take part in the refinement.
+    const size_t begin = first[t * rho_bins + max(0, r - 1)];
+    const size_t end = first[t * rho_bins + min(rho_bins, r + 2)];
+    if (begin == end) continue;
+    const double theta_center = t * options.coarse_theta_step;
+    // RhoBin() truncates toward zero: bin k > 0 holds rho in [k, k + 1)
+    // coarse steps, bin k < 0 holds (k - 1, k] and bin 0 holds (-1, 1).
+    const int k = r - accumulator.rho_offset();
+    const double rho_center =
+        (k > 0 ? k + 0.5 : (k < 0 ? k - 0.5 : 0.0)) * options.coarse_rho_step;
+    HoughLine line;
+    if (RefinePeak(bucketed.data() + begin, end - begin, theta_center, rho_center,
+                   theta_half_width, rho_half_width, options, &line))
+      candidates.push_back(line);
+  }
+
+  // Neighboring coarse peaks can refine to the same line; keep the
+  // strongest one of each group.
+  sort(candidates.begin(), candidates.end(),
+       [](const HoughLine &a, const HoughLine &b) { return a.votes > b.votes; });
+  for (const HoughLine &candidate : candidates) {
+    bool duplicate = false;
+    for (const HoughLine &line : *lines) {
+      if (SameLine(candidate, line, options.coarse_theta_step, options.coarse_rho_step)) {
+        duplicate = true;
+        break;
+      }
+    }
+    if (!duplicate) lines->push_back(candidate);
+  }
+}
+
+void HoughToImage(const HoughAccumulator &accumulator, Image *hough_image) {
+  if (hough_image == nullptr) abort();
+  hough_image->AllocateSpaceAndSetSize(accumulator.theta_bins(), accumulator.rho_bins());
+  hough_image->SetNumberGrayLevels(255);
+
+  const int max_votes = accumulator.MaxVotes();
+  for (int r = 0; r < accumulator.rho_bins(); ++r) {
+    for (int t = 0; t < accumulator.theta_bins(); ++t) {
+      const int intensity =
+          max_votes > 0 ? static_cast<int>(255.0 * accumulator.votes(r, t) / max_votes) : 0;
+      hough_image->SetPixel(t, r, intensity);
+    }
+  }
+}
+
+}  // namespace ComputerVisionProjects
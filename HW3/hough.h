@@ -0,0 +1,110 @@
+// Name: Kevin Fang
+// Hough transform for straight lines. Supports the dense
+// 1-degree x 1-pixel voting array used by h3.cc/h4.cc and a
+// coarse-to-fine (hierarchical) mode that only refines the
+// neighborhoods of real peaks at fine resolution.
+
+#ifndef COMPUTER_VISION_HOUGH_H_
+#define COMPUTER_VISION_HOUGH_H_
+
+#include <cstdlib>
+#include <vector>
+
+#include "image.h"
+
+namespace ComputerVisionProjects {
+
+// An edge pixel of a binary edge image (x is the column, y the row).
+struct EdgePoint {
+  int x;
+  int y;
+};
+
+// A line rho = x * cos(theta) + y * sin(theta), theta in degrees
+// within [0, 180).
+struct HoughLine {
+  double rho;
+  double theta;
+  int votes;
+};
+
+// Collects every pixel of edge_image that is > 0 into points.
+void CollectEdgePoints(const Image &edge_image, std::vector<EdgePoint> *points);
+
+// Voting array over (rho, theta). Cells are stored rho-major, exactly
+// like the array written by h3.cc: cell (r, t) holds the votes of
+// theta = t * theta_step and rho = (r - rho_offset) * rho_step.
+// Sample usage:
+//   HoughAccumulator accumulator;
+//   accumulator.Reset(num_rows, num_columns, 1.0, 1.0);
+//   accumulator.Vote(points);
+class HoughAccumulator {
+ public:
+  HoughAccumulator(): theta_bins_{0}, rho_bins_{0}, rho_offset_{0},
+                      theta_step_{1.0}, rho_step_{1.0} { }
+
+  // Sizes the accumulator for an image of the given size and clears
+  // all votes. theta_step is in degrees, rho_step in pixels. Calling it
+  // again with the same geometry reuses the existing storage.
+  void Reset(size_t num_rows, size_t num_columns,
+             double theta_step, double rho_step);
+
+  // Adds one vote per theta bin for every point.
+  void Vote(const std::vector<EdgePoint> &points);
+
+  // Bin of rho for a given theta bin; may lie outside [0, rho_bins()).
+  int RhoBin(const EdgePoint &point, int t) const {
+    const double rho = point.x * cos_table_[t] + point.y * sin_table_[t];
+    return static_cast<int>(rho / rho_step_) + rho_offset_;
+  }
+
+  int theta_bins() const { return theta_bins_; }
+  int rho_bins() const { return rho_bins_; }
+  int rho_offset() const { return rho_offset_; }
+  double theta_step() const { return theta_step_; }
+  double rho_step() const { return rho_step_; }
+
+  int votes(int r, int t) const { return votes_[r * theta_bins_ + t]; }
+  int MaxVotes() const;
+
+ private:
+  int theta_bins_;
+  int rho_bins_;
+  int rho_offset_;
+  double theta_step_;
+  double rho_step_;
+  std::vector<double> cos_table_;
+  std::vector<double> sin_table_;
+  std::vector<int> votes_;
+};
+
+// Parameters of DetectLinesHierarchical(). Steps are in degrees
+// for theta and in pixels for rho.
+struct HierarchicalHoughOptions {
+  double coarse_theta_step = 4.0;
+  double coarse_rho_step = 4.0;
+  double fine_theta_step = 0.25;
+  double fine_rho_step = 1.0;
+  // Minimum number of coarse votes for a cell to be a candidate peak;
+  // values below 1 count as 1.
+  int threshold = 1;
+};
+
+// Votes all points into a coarse accumulator, keeps the cells that are
+// local maxima with at least options.threshold votes, and refines each
+// of them at fine resolution using only the points that voted into its
+// neighborhood. The refined lines are returned in lines, strongest first.
+// If coarse is not nullptr it receives the coarse accumulator.
+void DetectLinesHierarchical(const std::vector<EdgePoint> &points,
+                             size_t num_rows, size_t num_columns,
+                             const HierarchicalHoughOptions &options,
+                             std::vector<HoughLine> *lines,
+                             HoughAccumulator *coarse = nullptr);
+
+// Renders the accumulator as a gray-level image (theta along the rows,
+// rho along the columns) scaled so that the strongest cell is 255.
+void HoughToImage(const HoughAccumulator &accumulator, Image *hough_image);
+
+}  // namespace ComputerVisionProjects
+
+#endif  // COMPUTER_VISION_HOUGH_H_
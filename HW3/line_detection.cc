@@ -0,0 +1,154 @@
+// Name: Kevin Fang
+// In-memory line detection pipeline: Sobel edges (h1), edge
+// thresholding (h2), Hough voting (h3) and peak extraction (h4)
+// without passing any intermediate file between the stages.
+
+#include "line_detection.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace ComputerVisionProjects {
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+
+// h4's peak extraction: every cell with at least threshold votes gives
+// a line at the (integer) weighted center of its thresholded 3x3
+// neighborhood.
+void ExtractPeaks(const HoughAccumulator &accumulator, int threshold,
+                  vector<HoughLine> *lines) {
+  const int rho_bins = accumulator.rho_bins();
+  const int theta_bins = accumulator.theta_bins();
+  auto thresholded = [&](int r, int t) {
+    const int votes = accumulator.votes(r, t);
+    return votes < threshold ? 0 : votes;
+  };
+
+  for (int r = 0; r < rho_bins; ++r) {
+    for (int t = 0; t < theta_bins; ++t) {
+      if (thresholded(r, t) == 0) continue;
+      int weighted_sum_t = 0, weighted_sum_r = 0, total_weight = 0;
+      for (int dr = -1; dr <= 1; ++dr) {
+        for (int dt = -1; dt <= 1; ++dt) {
+          const int rr = r + dr, tt = t + dt;
+          if (rr < 0 || rr >= rho_bins || tt < 0 || tt >= theta_bins) continue;
+          const int weight = thresholded(rr, tt);
+          weighted_sum_t += tt * weight;
+          weighted_sum_r += rr * weight;
+          total_weight += weight;
+        }
+      }
+      HoughLine line;
+      line.rho = (weighted_sum_r / total_weight - accumulator.rho_offset()) *
+                 accumulator.rho_step();
+      line.theta = (weighted_sum_t / total_weight) * accumulator.theta_step();
+      line.votes = accumulator.votes(r, t);
+      lines->push_back(line);
+    }
+  }
+}
+
+}  // namespace
+
+void LineDetector::ComputeEdges(const Image &gray_image) {
+  const int rows = gray_image.num_rows();
+  const int cols = gray_image.num_columns();
+  for (int i = 0; i < rows; ++i)
+    for (int j = 0; j < cols; ++j)
+      pixels_[i * cols + j] = gray_image.GetPixel(i, j);
+
+  fill(edges_.begin(), edges_.end(), 0);
+  for (int i = 1; i < rows - 1; ++i) {
+    const int *above = &pixels_[(i - 1) * cols];
+    const int *center = &pixels_[i * cols];
+    const int *below = &pixels_[(i + 1) * cols];
+    for (int j = 1; j < cols - 1; ++j) {
+      const int gradient_x = (above[j + 1] + 2 * center[j + 1] + below[j + 1]) -
+                             (above[j - 1] + 2 * center[j - 1] + below[j - 1]);
+      const int gradient_y = (above[j - 1] + 2 * above[j] + above[j + 1]) -
+                             (below[j - 1] + 2 * below[j] + below[j + 1]);
+      const int magnitude = gradient_x * gradient_x + gradient_y * gradient_y;
+      edges_[i * cols + j] = min(255, static_cast<int>(sqrt(magnitude)));
+    }
+  }
+}
+
+void LineDetector::Detect(const Image &gray_image, const LineDetectionOptions &options,
+                          vector<HoughLine> *lines, const LineDetectionStages *stages) {
+  if (lines == nullptr) abort();
+  lines->clear();
+
+  num_rows_ = gray_image.num_rows();
+  num_columns_ = gray_image.num_columns();
+  pixels_.resize(num_rows_ * num_columns_);
+  edges_.resize(num_rows_ * num_columns_);
+  ComputeEdges(gray_image);
+
+  // Thresholding goes straight into the list of edge points.
+  points_.clear();
+  for (size_t i = 0; i < num_rows_; ++i)
+    for (size_t j = 0; j < num_columns_; ++j)
+      if (edges_[i * num_columns_ + j] > options.edge_threshold)
+        points_.push_back({static_cast<int>(j), static_cast<int>(i)});
+
+  if (options.hierarchical) {
+    HierarchicalHoughOptions hierarchical_options = options.hierarchical_options;
+    hierarchical_options.threshold = options.hough_threshold;
+    DetectLinesHierarchical(points_, num_rows_, num_columns_, hierarchical_options,
+                            lines, &accumulator_);
+  } else {
+    accumulator_.Reset(num_rows_, num_columns_, 1.0, 1.0);
+    accumulator_.Vote(points_);
+    ExtractPeaks(accumulator_, options.hough_threshold, lines);
+  }
+
+  if (stages == nullptr) return;
+  if (stages->gray_edge != nullptr || stages->binary_edge != nullptr) {
+    for (Image *stage : {stages->gray_edge, stages->binary_edge}) {
+      if (stage == nullptr) continue;
+      stage->AllocateSpaceAndSetSize(num_rows_, num_columns_);
+      stage->SetNumberGrayLevels(255);
+    }
+    for (size_t i = 0; i < num_rows_; ++i) {
+      for (size_t j = 0; j < num_columns_; ++j) {
+        const int edge = edges_[i * num_columns_ + j];
+        if (stages->gray_edge != nullptr) stages->gray_edge->SetPixel(i, j, edge);
+        if (stages->binary_edge != nullptr)
+          stages->binary_edge->SetPixel(i, j, edge > options.edge_threshold ? 255 : 0);
+      }
+    }
+  }
+  if (stages->hough != nullptr) HoughToImage(accumulator_, stages->hough);
+}
+
+void DrawDetectedLines(const vector<HoughLine> &lines, int color, Image *an_image) {
+  if (an_image == nullptr) abort();
+  const int width = an_image->num_columns();
+  const int height = an_image->num_rows();
+
+  for (const HoughLine &line : lines) {
+    const double theta = line.theta * kPi / 180.0;
+    const double cos_theta = cos(theta);
+    const double sin_theta = sin(theta);
+
+    // Scan along whichever axes the line is not parallel to.
+    if (fabs(sin_theta) > 1e-9) {
+      for (int x = 0; x < width; ++x) {
+        const int y = static_cast<int>((line.rho - x * cos_theta) / sin_theta);
+        if (y >= 0 && y < height) an_image->SetPixel(y, x, color);
+      }
+    }
+    if (fabs(cos_theta) > 1e-9) {
+      for (int y = 0; y < height; ++y) {
+        const int x = static_cast<int>((line.rho - y * sin_theta) / cos_theta);
+        if (x >= 0 && x < width) an_image->SetPixel(y, x, color);
+      }
+    }
+  }
+}
+
+}  // namespace ComputerVisionProjects
@@ -0,0 +1,72 @@
+// Name: Kevin Fang
+// In-memory line detection pipeline: Sobel edges (h1), edge
+// thresholding (h2), Hough voting (h3) and peak extraction (h4)
+// without passing any intermediate file between the stages.
+
+#ifndef COMPUTER_VISION_LINE_DETECTION_H_
+#define COMPUTER_VISION_LINE_DETECTION_H_
+
+#include <vector>
+
+#include "hough.h"
+#include "image.h"
+
+namespace ComputerVisionProjects {
+
+struct LineDetectionOptions {
+  // Gradient magnitudes above this value are edges (h2's threshold).
+  int edge_threshold = 50;
+  // Minimum votes of a Hough cell (h4's threshold). In hierarchical
+  // mode this is the coarse vote threshold instead.
+  int hough_threshold = 290;
+  // Use DetectLinesHierarchical() instead of the dense accumulator.
+  bool hierarchical = false;
+  HierarchicalHoughOptions hierarchical_options;
+};
+
+// Optional outputs of the intermediate stages. Every stage whose
+// pointer is left as nullptr is never materialized as an Image.
+struct LineDetectionStages {
+  Image *gray_edge = nullptr;    // Output of h1.
+  Image *binary_edge = nullptr;  // Output of h2.
+  Image *hough = nullptr;        // Output of h3.
+};
+
+// Runs the whole h1 -> h4 chain on one gray-level frame. The stage
+// buffers are kept inside the detector and reused for every frame of
+// the same size, so a detector should live as long as the stream.
+// Sample usage:
+//   LineDetector detector;
+//   std::vector<HoughLine> lines;
+//   for (each frame) {
+//     detector.Detect(frame, options, &lines);
+//     DrawDetectedLines(lines, 100, &frame);
+//   }
+class LineDetector {
+ public:
+  // Dense mode returns one line per above-threshold cell, located at the
+  // weighted center of its 3x3 neighborhood exactly like h4.cc.
+  void Detect(const Image &gray_image, const LineDetectionOptions &options,
+              std::vector<HoughLine> *lines,
+              const LineDetectionStages *stages = nullptr);
+
+ private:
+  // Sobel magnitude of the frame, clamped to 255; the border is 0.
+  void ComputeEdges(const Image &gray_image);
+
+  size_t num_rows_ = 0;
+  size_t num_columns_ = 0;
+  std::vector<int> pixels_;
+  std::vector<int> edges_;
+  std::vector<EdgePoint> points_;
+  HoughAccumulator accumulator_;
+};
+
+// Draws every line across the whole image in the given gray-level,
+// the same way h4.cc does.
+void DrawDetectedLines(const std::vector<HoughLine> &lines, int color,
+                       Image *an_image);
+
+}  // namespace ComputerVisionProjects
+
+#endif  // COMPUTER_VISION_LINE_DETECTION_H_
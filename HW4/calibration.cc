@@ -0,0 +1,280 @@
+// Name: Kevin Fang
+// Light calibration for photometric stereo: locating the calibration
+// sphere, measuring one light direction per sphere image, and saving
+// all of it (with the light pseudo-inverse) as one calibration file
+// that later runs load instead of redoing s1 and s2.
+
+#include "calibration.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+#include "circle_fit.h"
+#include "circle_hough.h"
+#include "distance_transform.h"
+
+using namespace std;
+
+namespace ComputerVisionProjects {
+
+namespace {
+
+// Pixels past this fraction of the radius mix sphere and background.
+const double kRimFraction = 0.95;
+
+// Pixels at or below this fraction of the brightest pixel on the disc
+// are taken as shadowed, where the Lambertian model does not hold.
+const double kShadowFraction = 0.1;
+
+double Determinant(const double m[3][3]) {
+  return m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) -
+         m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0]) +
+         m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+}
+
+}  // namespace
+
+bool LocateSphereByDistance(const Image &an_image, int threshold, Sphere *sphere) {
+  if (sphere == nullptr) abort();
+  const size_t rows = an_image.num_rows();
+  const size_t cols = an_image.num_columns();
+  vector<unsigned char> mask(rows * cols);
+  for (size_t y = 0; y < rows; ++y)
+    for (size_t x = 0; x < cols; ++x) mask[y * cols + x] = an_image.GetPixel(y, x) >= threshold;
+
+  vector<int> squared_distances;
+  const int largest = EuclideanDistanceTransform(mask, rows, cols, 0, &squared_distances);
+  if (largest == 0) return false;
+
+  double x_sum = 0, y_sum = 0;
+  int count = 0;
+  for (size_t k = 0; k < squared_distances.size(); ++k) {
+    if (squared_distances[k] != largest) continue;
+    x_sum += k % cols;
+    y_sum += k / cols;
+    ++count;
+  }
+  sphere->x_center = x_sum / count;
+  sphere->y_center = y_sum / count;
+  // The nearest background pixel's center is half a pixel past the edge.
+  sphere->radius = sqrt(static_cast<double>(largest)) - 0.5;
+  return true;
+}
+
+bool LocateSphereByFit(const Image &an_image, int threshold, bool ransac, Sphere *sphere) {
+  if (sphere == nullptr) abort();
+  const int rows = an_image.num_rows();
+  const int cols = an_image.num_columns();
+  // Without RANSAC the points go straight into the sums and are not
+  // kept.
+  CircleFitSums sums;
+  vector<CirclePoint> points;
+  const auto add = [&](double x, double y) {
+    if (ransac)
+      points.push_back({x, y});
+    else
+      sums.Add(x, y);
+  };
+  const int kNeighbors[4][2] = {{0, -1}, {0, 1}, {-1, 0}, {1, 0}};
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) {
+      if (an_image.GetPixel(i, j) < threshold) continue;
+      for (const auto &neighbor : kNeighbors) {
+        const int y = i + neighbor[0], x = j + neighbor[1];
+        // The image border is not the sphere's edge.
+        if (y < 0 || y >= rows || x < 0 || x >= cols) continue;
+        if (an_image.GetPixel(y, x) < threshold) add(j + 0.5 * neighbor[1], i + 0.5 * neighbor[0]);
+      }
+    }
+  }
+
+  Circle circle;
+  CircleFitOptions options;
+  options.ransac = ransac;
+  if (!(ransac ? FitCircle(points, options, &circle) : sums.Fit(options.method, &circle)))
+    return false;
+  sphere->x_center = circle.x_center;
+  sphere->y_center = circle.y_center;
+  sphere->radius = circle.radius;
+  return true;
+}
+
+bool LocateSphereByHough(const Image &an_image, Sphere *sphere) {
+  if (sphere == nullptr) abort();
+  // The sphere is brighter than the background, so only vote toward
+  // increasing intensity.
+  CircleHoughOptions options;
+  options.both_directions = false;
+  Circle circle;
+  if (!DetectCircle(an_image, options, &circle)) return false;
+  sphere->x_center = circle.x_center;
+  sphere->y_center = circle.y_center;
+  sphere->radius = circle.radius;
+  return true;
+}
+
+bool MeasureLightDirection(const Image &an_image, const Sphere &sphere,
+                           LightDirection *direction) {
+  if (direction == nullptr) abort();
+  if (sphere.radius <= 0) return false;
+  // Only the bounding box of the disc is scanned.
+  const int first_row = max(0, static_cast<int>(floor(sphere.y_center - sphere.radius)));
+  const int last_row = min(static_cast<int>(an_image.num_rows()) - 1,
+                           static_cast<int>(ceil(sphere.y_center + sphere.radius)));
+  const int first_column = max(0, static_cast<int>(floor(sphere.x_center - sphere.radius)));
+  const int last_column = min(static_cast<int>(an_image.num_columns()) - 1,
+                              static_cast<int>(ceil(sphere.x_center + sphere.radius)));
+  const double rim_squared = kRimFraction * kRimFraction;
+
+  int brightest = 0;
+  for (int i = first_row; i <= last_row; ++i) {
+    for (int j = first_column; j <= last_column; ++j) {
+      const double nx = (j - sphere.x_center) / sphere.radius;
+      const double ny = (i - sphere.y_center) / sphere.radius;
+      if (nx * nx + ny * ny <= rim_squared) brightest = max(brightest, an_image.GetPixel(i, j));
+    }
+  }
+  const double shadow_level = kShadowFraction * brightest;
+
+  // Normal equations of min sum (I - n.s)^2 over the lit pixels.
+  double normal_matrix[3][3] = {{0}}, right_side[3] = {0};
+  int count = 0;
+  for (int i = first_row; i <= last_row; ++i) {
+    for (int j = first_column; j <= last_column; ++j) {
+      const double nx = (j - sphere.x_center) / sphere.radius;
+      const double ny = (i - sphere.y_center) / sphere.radius;
+      const double rho_squared = nx * nx + ny * ny;
+      const int pixel_value = an_image.GetPixel(i, j);
+      if (rho_squared > rim_squared || pixel_value <= shadow_level) continue;
+      const double normal[3] = {nx, ny, sqrt(1.0 - rho_squared)};
+      for (int r = 0; r < 3; ++r) {
+        right_side[r] += normal[r] * pixel_value;
+        for (int c = 0; c < 3; ++c) normal_matrix[r][c] += normal[r] * normal[c];
+      }
+      ++count;
+    }
+  }
+  if (count < 3) return false;
+
+  // Cramer's rule; the matrix is a sum of outer products, so it is
+  // singular only if the lit pixels lie on one plane through the center.
+  const double determinant = Determinant(normal_matrix);
+  if (fabs(determinant) < 1e-12 * count * count * count) return false;
+  for (int k = 0; k < 3; ++k) {
+    double replaced[3][3];
+    for (int r = 0; r < 3; ++r)
+      for (int c = 0; c < 3; ++c) replaced[r][c] = (c == k) ? right_side[r] : normal_matrix[r][c];
+    (*direction)[k] = Determinant(replaced) / determinant;
+  }
+  return true;
+}
+
+bool MeasureLightDirections(const vector<string> &filenames, const Sphere &sphere,
+                            vector<LightDirection> *directions) {
+  if (directions == nullptr) abort();
+  const size_t num_images = filenames.size();
+  directions->assign(num_images, LightDirection());
+  // One thread per image: reading dominates and the images are few.
+  vector<char> measured(num_images, 0);
+  vector<thread> threads;
+  for (size_t k = 0; k < num_images; ++k) {
+    threads.emplace_back([&, k] {
+      Image image;
+      measured[k] = ReadImage(filenames[k], &image) &&
+                    MeasureLightDirection(image, sphere, &(*directions)[k]);
+    });
+  }
+  for (thread &worker : threads) worker.join();
+  for (size_t k = 0; k < num_images; ++k) {
+    if (!measured[k]) {
+      cout << "MeasureLightDirections: failed on " << filenames[k] << endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool WriteCalibration(const string &filename, const Calibration &calibration,
+                      const LightSet &lights) {
+  const int num_lights = calibration.directions.size();
+  if (lights.num_lights() != num_lights) abort();
+  ofstream output(filename);
+  if (!output.is_open()) {
+    cout << "WriteCalibration: cannot open file" << endl;
+    return false;
+  }
+  output << setprecision(9);
+  output << "sphere " << calibration.sphere.x_center << " " << calibration.sphere.y_center << " "
+         << calibration.sphere.radius << "\n";
+  output << "lights " << num_lights << "\n";
+  for (const LightDirection &direction : calibration.directions)
+    output << direction[0] << " " << direction[1] << " " << direction[2] << "\n";
+  output << "pseudo_inverse\n";
+  for (int r = 0; r < 3; ++r) {
+    for (int k = 0; k < num_lights; ++k)
+      output << (k > 0 ? " " : "") << lights.pseudo_inverse()[r * num_lights + k];
+    output << "\n";
+  }
+  if (!output) {
+    cout << "WriteCalibration: could not write" << endl;
+    return false;
+  }
+  return true;
+}
+
+bool ReadCalibration(const string &filename, Calibration *calibration, LightSet *lights) {
+  if (calibration == nullptr || lights == nullptr) abort();
+  ifstream input(filename);
+  if (!input.is_open()) {
+    cout << "ReadCalibration: cannot open file" << endl;
+    return false;
+  }
+  string word;
+  int num_lights = 0;
+  if (!(input >> word) || word != "sphere" ||
+      !(input >> calibration->sphere.x_center >> calibration->sphere.y_center >>
+        calibration->sphere.radius) ||
+      !(input >> word) || word != "lights" || !(input >> num_lights) || num_lights < 3) {
+    cout << "ReadCalibration: bad header" << endl;
+    return false;
+  }
+  calibration->directions.resize(num_lights);
+  for (LightDirection &direction : calibration->directions) {
+    if (!(input >> direction[0] >> direction[1] >> direction[2])) {
+      cout << "ReadCalibration: bad light direction" << endl;
+      return false;
+    }
+  }
+  vector<double> stored(3 * num_lights);
+  if (!(input >> word) || word != "pseudo_inverse") {
+    cout << "ReadCalibration: missing pseudo_inverse" << endl;
+    return false;
+  }
+  for (double &value : stored) {
+    if (!(input >> value)) {
+      cout << "ReadCalibration: bad pseudo_inverse" << endl;
+      return false;
+    }
+  }
+
+  if (!lights->Set(calibration->directions)) {
+    cout << "ReadCalibration: light directions don't span 3-D" << endl;
+    return false;
+  }
+  double largest = 0;
+  for (int k = 0; k < 3 * num_lights; ++k)
+    largest = max(largest, fabs(static_cast<double>(lights->pseudo_inverse()[k])));
+  for (int k = 0; k < 3 * num_lights; ++k) {
+    if (fabs(lights->pseudo_inverse()[k] - stored[k]) > 1e-4 * largest) {
+      cout << "ReadCalibration: pseudo_inverse doesn't match the light directions" << endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace ComputerVisionProjects
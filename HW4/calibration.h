@@ -0,0 +1,85 @@
+// Name: Kevin Fang
+// Light calibration for photometric stereo: locating the calibration
+// sphere, measuring one light direction per sphere image, and saving
+// all of it (with the light pseudo-inverse) as one calibration file
+// that later runs load instead of redoing s1 and s2.
+
+#ifndef COMPUTER_VISION_CALIBRATION_H_
+#define COMPUTER_VISION_CALIBRATION_H_
+
+#include <string>
+#include <vector>
+
+#include "image.h"
+#include "photometric_stereo.h"
+
+namespace ComputerVisionProjects {
+
+// A sphere in image coordinates (x is the column, y the row).
+struct Sphere {
+  double x_center = 0;
+  double y_center = 0;
+  double radius = 0;
+};
+
+// Locates the sphere as the largest disc of the pixels >= threshold:
+// the deepest pixels of the Euclidean distance transform give the
+// center (averaged when several are equally deep), and their distance
+// to the background, less half a pixel, gives the radius.
+// Returns false if there is no such disc.
+bool LocateSphereByDistance(const Image &an_image, int threshold, Sphere *sphere);
+
+// Locates the sphere with a least-squares circle fit (circle_fit.h) to
+// the boundary of the pixels >= threshold: the midpoints between each
+// pixel >= threshold and its 4-neighbors below it, accumulated in one
+// pass over the image. With ransac, boundary points off the circle
+// (specks and bright spots around the sphere) are left out of the fit.
+// Returns false if there is no boundary or no circle fits it.
+bool LocateSphereByFit(const Image &an_image, int threshold, bool ransac, Sphere *sphere);
+
+// Locates the sphere with the gradient-based circle Hough transform
+// (bright sphere on a dark background). Returns false if there are no
+// edges.
+bool LocateSphereByHough(const Image &an_image, Sphere *sphere);
+
+// Light direction from an image of the sphere: the least-squares fit of
+// the Lambertian model I = n.s over the lit pixels of the disc, whose
+// normals n are known from the sphere. The direction s is scaled by the
+// light's brightness (the intensity of a pixel facing it). Using the
+// whole disc rather than its brightest pixel makes the direction sub-pixel
+// and insensitive to noise and to hot pixels off the sphere.
+// Returns false if too few pixels of the disc are lit to fit.
+bool MeasureLightDirection(const Image &an_image, const Sphere &sphere,
+                           LightDirection *direction);
+
+// Reads every image and measures its light direction, all images at
+// once on their own threads. directions gets one entry per filename.
+// Returns false if an image can't be read or measured.
+bool MeasureLightDirections(const std::vector<std::string> &filenames, const Sphere &sphere,
+                            std::vector<LightDirection> *directions);
+
+// Everything s1 and s2 measure for one light setup.
+struct Calibration {
+  Sphere sphere;
+  std::vector<LightDirection> directions;
+};
+
+// Writes the calibration as text:
+//   sphere <x center> <y center> <radius>
+//   lights <N>
+//   N lines of <x> <y> <z>
+//   pseudo_inverse
+//   3 lines of N values (lights.pseudo_inverse())
+// Returns true if everything is OK, false otherwise.
+bool WriteCalibration(const std::string &filename, const Calibration &calibration,
+                      const LightSet &lights);
+
+// Reads a calibration written by WriteCalibration() and sets lights
+// from its directions. The stored pseudo-inverse must agree with them,
+// so a file whose directions were edited by hand is caught.
+// Returns true if everything is OK, false otherwise.
+bool ReadCalibration(const std::string &filename, Calibration *calibration, LightSet *lights);
+
+}  // namespace ComputerVisionProjects
+
+#endif  // COMPUTER_VISION_CALIBRATION_H_
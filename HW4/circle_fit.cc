@@ -0,0 +1,169 @@
+// Name: Kevin Fang
+// Algebraic least-squares circle fits (Kasa and Pratt) from moment sums
+// accumulated one point at a time, with optional RANSAC rejection of
+// points that are not on the circle.
+
+#include "circle_fit.h"
+
+#include <cmath>
+#include <random>
+
+using namespace std;
+
+namespace ComputerVisionProjects {
+
+namespace {
+
+// Circle through three points, false if they are (nearly) collinear.
+bool CircleThroughPoints(const CirclePoint &a, const CirclePoint &b, const CirclePoint &c,
+                         Circle *circle) {
+  const double bx = b.x - a.x, by = b.y - a.y;
+  const double cx = c.x - a.x, cy = c.y - a.y;
+  const double d = 2.0 * (bx * cy - by * cx);
+  if (fabs(d) < 1e-9) return false;
+  const double b_squared = bx * bx + by * by;
+  const double c_squared = cx * cx + cy * cy;
+  const double ux = (cy * b_squared - by * c_squared) / d;
+  const double uy = (bx * c_squared - cx * b_squared) / d;
+  circle->x_center = a.x + ux;
+  circle->y_center = a.y + uy;
+  circle->radius = sqrt(ux * ux + uy * uy);
+  return true;
+}
+
+bool IsInlier(const CirclePoint &point, const Circle &circle, double inlier_distance) {
+  const double distance = hypot(point.x - circle.x_center, point.y - circle.y_center);
+  return fabs(distance - circle.radius) <= inlier_distance;
+}
+
+}  // namespace
+
+void CircleFitSums::Add(double x, double y) {
+  if (count_ == 0) {
+    origin_x_ = x;
+    origin_y_ = y;
+  }
+  x -= origin_x_;
+  y -= origin_y_;
+  const double z = x * x + y * y;
+  zz_ += z * z;
+  zx_ += z * x;
+  zy_ += z * y;
+  z_ += z;
+  xx_ += x * x;
+  xy_ += x * y;
+  x_ += x;
+  yy_ += y * y;
+  y_ += y;
+  ++count_;
+}
+
+bool CircleFitSums::Fit(CircleFitMethod method, Circle *circle) const {
+  if (circle == nullptr) abort();
+  if (count_ < 3) return false;
+  const double n = count_;
+  const double mean_x = x_ / n, mean_y = y_ / n;
+
+  // Second moments of (z, x, y, 1), then moved to the centroid: there
+  // X = x - mean_x, Y = y - mean_y and Z = X^2 + Y^2 = z - 2 mean_x x -
+  // 2 mean_y y + mean_x^2 + mean_y^2, a linear map L of (z, x, y, 1), so
+  // the centered moments are L M L^T.
+  const double raw[4][4] = {{zz_ / n, zx_ / n, zy_ / n, z_ / n},
+                            {zx_ / n, xx_ / n, xy_ / n, mean_x},
+                            {zy_ / n, xy_ / n, yy_ / n, mean_y},
+                            {z_ / n, mean_x, mean_y, 1}};
+  const double shift[4][4] = {{1, -2 * mean_x, -2 * mean_y, mean_x * mean_x + mean_y * mean_y},
+                              {0, 1, 0, -mean_x},
+                              {0, 0, 1, -mean_y},
+                              {0, 0, 0, 1}};
+  double centered[4][4] = {{0}};
+  for (int r = 0; r < 4; ++r)
+    for (int c = 0; c < 4; ++c)
+      for (int k = 0; k < 4; ++k)
+        for (int l = 0; l < 4; ++l) centered[r][c] += shift[r][k] * raw[k][l] * shift[c][l];
+  const double mzz = centered[0][0], mxz = centered[0][1], myz = centered[0][2];
+  const double mxx = centered[1][1], mxy = centered[1][2], myy = centered[2][2];
+  const double mz = mxx + myy;
+
+  const double cov_xy = mxx * myy - mxy * mxy;
+  // Pratt's constraint adds the root eta of a quartic (Chernov's Newton
+  // iteration from eta = 0); Kasa's fit is eta = 0.
+  double eta = 0;
+  if (method == CircleFitMethod::kPratt) {
+    const double mxz2 = mxz * mxz, myz2 = myz * myz;
+    const double a2 = 4 * cov_xy - 3 * mz * mz - mzz;
+    const double a1 = mzz * mz + 4 * cov_xy * mz - mxz2 - myz2 - mz * mz * mz;
+    const double a0 = mxz2 * myy + myz2 * mxx - mzz * cov_xy - 2 * mxz * myz * mxy +
+                      mz * mz * cov_xy;
+    double value = 1e20;
+    for (int iteration = 0; iteration < 20; ++iteration) {
+      const double previous_value = value;
+      value = a0 + eta * (a1 + eta * (a2 + 4 * eta * eta));
+      if (fabs(value) > fabs(previous_value)) {
+        eta = 0;
+        break;
+      }
+      const double slope = a1 + eta * (2 * a2 + 16 * eta * eta);
+      const double previous = eta;
+      eta = previous - value / slope;
+      if (!(eta >= 0)) {
+        eta = 0;
+        break;
+      }
+      if (fabs(eta - previous) <= 1e-12 * eta) break;
+    }
+  }
+
+  const double determinant = eta * eta - eta * mz + cov_xy;
+  if (!(fabs(determinant) > 1e-12 * mz * mz)) return false;
+  const double center_x = (mxz * (myy - eta) - myz * mxy) / (2 * determinant);
+  const double center_y = (myz * (mxx - eta) - mxz * mxy) / (2 * determinant);
+  circle->x_center = origin_x_ + mean_x + center_x;
+  circle->y_center = origin_y_ + mean_y + center_y;
+  circle->radius = sqrt(center_x * center_x + center_y * center_y + mz + 2 * eta);
+  circle->votes = count_;
+  return true;
+}
+
+bool FitCircle(const vector<CirclePoint> &points, const CircleFitOptions &options,
+               Circle *circle) {
+  if (circle == nullptr) abort();
+  if (points.size() < 3) return false;
+  if (!options.ransac) {
+    CircleFitSums sums;
+    for (const CirclePoint &point : points) sums.Add(point.x, point.y);
+    return sums.Fit(options.method, circle);
+  }
+
+  mt19937 generator(options.seed);
+  uniform_int_distribution<size_t> pick(0, points.size() - 1);
+  Circle best;
+  int best_inliers = 0;
+  for (int iteration = 0; iteration < options.ransac_iterations; ++iteration) {
+    Circle candidate;
+    if (!CircleThroughPoints(points[pick(generator)], points[pick(generator)],
+                             points[pick(generator)], &candidate))
+      continue;
+    int inliers = 0;
+    for (const CirclePoint &point : points)
+      inliers += IsInlier(point, candidate, options.inlier_distance);
+    if (inliers > best_inliers) {
+      best_inliers = inliers;
+      best = candidate;
+    }
+  }
+  if (best_inliers < 3) return false;
+
+  // Refit on the inliers, then once more on the inliers of the refit,
+  // which the three-point circle only approximated.
+  for (int round = 0; round < 2; ++round) {
+    CircleFitSums sums;
+    for (const CirclePoint &point : points)
+      if (IsInlier(point, best, options.inlier_distance)) sums.Add(point.x, point.y);
+    if (!sums.Fit(options.method, &best)) return false;
+  }
+  *circle = best;
+  return true;
+}
+
+}  // namespace ComputerVisionProjects
@@ -0,0 +1,74 @@
+// Name: Kevin Fang
+// Algebraic least-squares circle fits (Kasa and Pratt) from moment sums
+// accumulated one point at a time, with optional RANSAC rejection of
+// points that are not on the circle.
+
+#ifndef COMPUTER_VISION_CIRCLE_FIT_H_
+#define COMPUTER_VISION_CIRCLE_FIT_H_
+
+#include <vector>
+
+#include "circle_hough.h"
+
+namespace ComputerVisionProjects {
+
+struct CirclePoint {
+  double x;
+  double y;
+};
+
+enum class CircleFitMethod {
+  // Minimizes sum (d^2 - r^2)^2 over the points' distances d to the
+  // center. Closed form, but the radius shrinks when the points only
+  // cover a short arc.
+  kKasa,
+  // Normalizes the same algebraic distance by the circle's gradient,
+  // which removes the short-arc bias at the cost of a few Newton steps.
+  kPratt,
+};
+
+// Sums of the monomials of the points' coordinates up to degree four,
+// relative to the first point added (so the sums stay small enough not
+// to lose precision far from the image origin). Enough to fit a circle
+// without keeping the points.
+class CircleFitSums {
+ public:
+  void Add(double x, double y);
+  int count() const { return count_; }
+
+  // Fits a circle to the points added so far; circle->votes is their
+  // number. Returns false with fewer than 3 points or if they are
+  // collinear.
+  bool Fit(CircleFitMethod method, Circle *circle) const;
+
+ private:
+  int count_ = 0;
+  double origin_x_ = 0;
+  double origin_y_ = 0;
+  // Products of z = x^2 + y^2, x, y and 1.
+  double zz_ = 0, zx_ = 0, zy_ = 0, z_ = 0;
+  double xx_ = 0, xy_ = 0, x_ = 0;
+  double yy_ = 0, y_ = 0;
+};
+
+struct CircleFitOptions {
+  CircleFitMethod method = CircleFitMethod::kPratt;
+  // With RANSAC, circles through random triples of points are scored by
+  // how many points lie within inlier_distance pixels of them, and the
+  // final fit uses only the inliers of the best one. The default band
+  // allows for the pixel-ragged boundary of a thresholded noisy image.
+  bool ransac = false;
+  int ransac_iterations = 200;
+  double inlier_distance = 2.0;
+  unsigned int seed = 1;
+};
+
+// Fits a circle to points. circle->votes is the number of points the
+// fit used (the inliers with RANSAC).
+// Returns false if there are too few points or no circle fits them.
+bool FitCircle(const std::vector<CirclePoint> &points, const CircleFitOptions &options,
+               Circle *circle);
+
+}  // namespace ComputerVisionProjects
+
+#endif  // COMPUTER_VISION_CIRCLE_FIT_H_
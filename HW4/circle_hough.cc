@@ -0,0 +1,177 @@
+// Name: Kevin Fang
+// Gradient-based Hough transform for circles. Every edge pixel votes
+// only along the ray of its gradient direction, so the center
+// accumulator is 2-D and the radius is read off a 1-D histogram.
+
+#include "circle_hough.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "circle_fit.h"
+
+using namespace std;
+
+namespace ComputerVisionProjects {
+
+namespace {
+
+// An edge pixel with its unit gradient direction.
+struct EdgeElement {
+  int x;
+  int y;
+  double dx;
+  double dy;
+  double magnitude;
+};
+
+// Sobel gradients of an_image; keeps the pixels whose magnitude is at
+// least edge_fraction of the strongest one and not smaller than that of
+// the two neighbors along the gradient (non-maximum suppression), so
+// every edge is one pixel thick and centered on the intensity step.
+void CollectEdges(const Image &an_image, double edge_fraction,
+                  vector<EdgeElement> *edges) {
+  const int rows = an_image.num_rows();
+  const int cols = an_image.num_columns();
+  vector<int> pixels(rows * cols);
+  for (int i = 0; i < rows; ++i)
+    for (int j = 0; j < cols; ++j)
+      pixels[i * cols + j] = an_image.GetPixel(i, j);
+
+  vector<EdgeElement> gradients(rows * cols, EdgeElement{0, 0, 0, 0, 0});
+  double max_magnitude = 0;
+  for (int i = 1; i < rows - 1; ++i) {
+    const int *above = &pixels[(i - 1) * cols];
+    const int *center = &pixels[i * cols];
+    const int *below = &pixels[(i + 1) * cols];
+    for (int j = 1; j < cols - 1; ++j) {
+      const int gx = (above[j + 1] + 2 * center[j + 1] + below[j + 1]) -
+                     (above[j - 1] + 2 * center[j - 1] + below[j - 1]);
+      const int gy = (below[j - 1] + 2 * below[j] + below[j + 1]) -
+                     (above[j - 1] + 2 * above[j] + above[j + 1]);
+      if (gx == 0 && gy == 0) continue;
+      const double magnitude = sqrt(static_cast<double>(gx * gx + gy * gy));
+      gradients[i * cols + j] = {j, i, gx / magnitude, gy / magnitude, magnitude};
+      max_magnitude = max(max_magnitude, magnitude);
+    }
+  }
+
+  edges->clear();
+  for (int i = 1; i < rows - 1; ++i) {
+    for (int j = 1; j < cols - 1; ++j) {
+      const EdgeElement &element = gradients[i * cols + j];
+      if (element.magnitude == 0 || element.magnitude < edge_fraction * max_magnitude) continue;
+      // The neighbor the gradient points to, rounded to one of 8.
+      const int di = static_cast<int>(round(element.dy));
+      const int dj = static_cast<int>(round(element.dx));
+      if (element.magnitude < gradients[(i + di) * cols + j + dj].magnitude ||
+          element.magnitude <= gradients[(i - di) * cols + j - dj].magnitude) {
+        continue;
+      }
+      edges->push_back(element);
+    }
+  }
+}
+
+// Distance of edge from the center of circle and the cosine between its
+// gradient and the radius through it. Returns false if the gradient
+// points outward and only inward ones (bright objects) are wanted.
+bool RimGeometry(const EdgeElement &edge, const Circle &circle, bool both_directions,
+                 double *distance, double *alignment) {
+  const double rx = edge.x - circle.x_center;
+  const double ry = edge.y - circle.y_center;
+  *distance = sqrt(rx * rx + ry * ry);
+  if (*distance == 0) return false;
+  const double cosine = (rx * edge.dx + ry * edge.dy) / *distance;
+  if (!both_directions && cosine > 0) return false;
+  *alignment = fabs(cosine);
+  return true;
+}
+
+}  // namespace
+
+bool DetectCircle(const Image &an_image, const CircleHoughOptions &options,
+                  Circle *circle) {
+  if (circle == nullptr) abort();
+  const int rows = an_image.num_rows();
+  const int cols = an_image.num_columns();
+  const int min_radius = max(1, options.min_radius);
+  const int max_radius = options.max_radius > 0 ? options.max_radius : min(rows, cols) / 2;
+  if (max_radius < min_radius) return false;
+
+  vector<EdgeElement> edges;
+  CollectEdges(an_image, options.edge_fraction, &edges);
+  if (edges.empty()) return false;
+
+  // Each edge pixel walks its gradient ray over the radius range.
+  vector<int> accumulator(rows * cols, 0);
+  const int directions = options.both_directions ? 2 : 1;
+  for (const EdgeElement &edge : edges) {
+    for (int d = 0; d < directions; ++d) {
+      const double step_x = d == 0 ? edge.dx : -edge.dx;
+      const double step_y = d == 0 ? edge.dy : -edge.dy;
+      double x = edge.x + min_radius * step_x + 0.5;
+      double y = edge.y + min_radius * step_y + 0.5;
+      for (int r = min_radius; r <= max_radius; ++r, x += step_x, y += step_y) {
+        if (x < 0 || y < 0 || x >= cols || y >= rows) break;
+        ++accumulator[static_cast<int>(y) * cols + static_cast<int>(x)];
+      }
+    }
+  }
+
+  // The rays of a rim cross only roughly at the center (the gradient
+  // direction is off by a few degrees), so the peak is the cell with the
+  // most votes in its 5x5 neighborhood rather than the single fullest one.
+  // Box sums along the rows, then along the columns.
+  vector<int> row_sums(rows * cols, 0), box_sums(rows * cols, 0);
+  for (int i = 0; i < rows; ++i)
+    for (int j = 2; j < cols - 2; ++j)
+      for (int k = -2; k <= 2; ++k) row_sums[i * cols + j] += accumulator[i * cols + j + k];
+  for (int i = 2; i < rows - 2; ++i)
+    for (int j = 0; j < cols; ++j)
+      for (int k = -2; k <= 2; ++k) box_sums[i * cols + j] += row_sums[(i + k) * cols + j];
+  const int peak = max_element(box_sums.begin(), box_sums.end()) - box_sums.begin();
+  const int peak_x = peak % cols;
+  const int peak_y = peak / cols;
+
+  circle->x_center = peak_x;
+  circle->y_center = peak_y;
+  circle->votes = accumulator[peak];
+
+  // Radius histogram over the edge pixels whose gradient points
+  // (roughly) toward or away from the center.
+  vector<double> histogram(max_radius + 2, 0.0);
+  for (const EdgeElement &edge : edges) {
+    double distance, alignment;
+    if (!RimGeometry(edge, *circle, options.both_directions, &distance, &alignment)) continue;
+    if (distance < min_radius || distance > max_radius || alignment < 0.9) continue;
+    histogram[static_cast<int>(distance + 0.5)] += edge.magnitude;
+  }
+  const int peak_radius = max_element(histogram.begin(), histogram.end()) - histogram.begin();
+  if (histogram[peak_radius] == 0) return false;
+  circle->radius = peak_radius;
+
+  // The accumulator peak is only good to a pixel or two: the votes of a
+  // thick rim spread over several cells, and the shading inside a sphere
+  // adds edges that pull the peak. The circle is refined by fitting it to
+  // the rim edges alone, the ones close to the current circle whose
+  // gradient is along its radius.
+  for (double band : {3.0, 2.0, 1.5}) {
+    CircleFitSums sums;
+    for (const EdgeElement &edge : edges) {
+      double distance, alignment;
+      if (!RimGeometry(edge, *circle, options.both_directions, &distance, &alignment)) continue;
+      if (fabs(distance - circle->radius) > band || alignment < 0.9) continue;
+      sums.Add(edge.x, edge.y);
+    }
+    Circle fitted;
+    if (!sums.Fit(CircleFitMethod::kPratt, &fitted)) break;
+    circle->x_center = fitted.x_center;
+    circle->y_center = fitted.y_center;
+    circle->radius = fitted.radius;
+  }
+  return true;
+}
+
+}  // namespace ComputerVisionProjects
@@ -0,0 +1,51 @@
+// Name: Kevin Fang
+// Gradient-based Hough transform for circles. Every edge pixel votes
+// only along the ray of its gradient direction, so the center
+// accumulator is 2-D and the radius is read off a 1-D histogram.
+
+#ifndef COMPUTER_VISION_CIRCLE_HOUGH_H_
+#define COMPUTER_VISION_CIRCLE_HOUGH_H_
+
+#include "image.h"
+
+namespace ComputerVisionProjects {
+
+// A circle in image coordinates (x is the column, y the row).
+struct Circle {
+  double x_center = 0;
+  double y_center = 0;
+  double radius = 0;
+  // Center votes of the accumulator peak (before the fit).
+  int votes = 0;
+};
+
+struct CircleHoughOptions {
+  // Radius range in pixels. A max_radius of 0 means half of the
+  // smaller image dimension.
+  int min_radius = 5;
+  int max_radius = 0;
+  // Edge pixels are the local maxima of the Sobel magnitude along the
+  // gradient whose magnitude is at least this fraction of the strongest
+  // one in the image, so no absolute gray-level threshold has to be
+  // tuned.
+  double edge_fraction = 0.25;
+  // Vote on both sides of each edge pixel. Otherwise only in the
+  // direction of increasing intensity (bright objects on a dark
+  // background, like the calibration sphere).
+  bool both_directions = true;
+};
+
+// Finds the strongest circle of an_image. The accumulator gives the
+// center to a pixel or two and the radius histogram the radius; both
+// are then refined by a least-squares circle fit (circle_fit.h) to the
+// rim edges alone, the edge pixels near that circle whose gradient is
+// along its radius, so shading and highlights inside the circle don't
+// pull the center. On synthetic spheres (sphere_check.cc) the center
+// comes out within 0.3 pixels.
+// Returns false if the image has no edges at all.
+bool DetectCircle(const Image &an_image, const CircleHoughOptions &options,
+                  Circle *circle);
+
+}  // namespace ComputerVisionProjects
+
+#endif  // COMPUTER_VISION_CIRCLE_HOUGH_H_
@@ -0,0 +1,31 @@
+// Name: Kevin Fang
+// Distance transforms of binary masks: the distance from every object
+// pixel to the nearest background pixel.
+
+#ifndef COMPUTER_VISION_DISTANCE_TRANSFORM_H_
+#define COMPUTER_VISION_DISTANCE_TRANSFORM_H_
+
+#include <cstdlib>
+#include <vector>
+
+namespace ComputerVisionProjects {
+
+// Exact Euclidean distance transform of mask (Felzenszwalb and
+// Huttenlocher): squared_distances gets, for every pixel, the squared
+// distance to the nearest background pixel (0 on the background), where
+// pixels outside the image count as background, so objects touching the
+// border are only as deep as their distance to it. It is separable: a
+// vertical pass over all columns, then the lower envelope of parabolas
+// along every row, each pass split among num_threads threads (0 means
+// one per hardware thread), in O(num_rows x num_columns) time overall.
+// If nearest is not null it gets the index (row * num_columns + column)
+// of that nearest background pixel, or -1 where it is outside the image.
+// Returns the largest squared distance.
+int EuclideanDistanceTransform(const std::vector<unsigned char> &mask, size_t num_rows,
+                               size_t num_columns, int num_threads,
+                               std::vector<int> *squared_distances,
+                               std::vector<int> *nearest = nullptr);
+
+}  // namespace ComputerVisionProjects
+
+#endif  // COMPUTER_VISION_DISTANCE_TRANSFORM_H_
@@ -0,0 +1,111 @@
+// Name: Kevin Fang
+// Radix-2 fast Fourier transforms of complex data, in 1-D and 2-D.
+// Sizes must be powers of two; pad with NextPowerOfTwo().
+
+#include "fft.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+using namespace std;
+
+namespace ComputerVisionProjects {
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+
+// Columns transformed together, so that each row of the block is read
+// from memory once per block instead of once per column.
+const size_t kColumnBlock = 16;
+
+// Runs body(begin, end) over [0, count) split into num_threads
+// contiguous ranges, one thread each.
+template <typename Body>
+void ParallelFor(size_t count, int num_threads, Body body) {
+  if (num_threads <= 0) num_threads = max(1u, thread::hardware_concurrency());
+  num_threads = max<size_t>(1, min<size_t>(num_threads, count));
+  vector<thread> threads;
+  for (int t = 1; t < num_threads; ++t)
+    threads.emplace_back(body, count * t / num_threads, count * (t + 1) / num_threads);
+  body(0, count / num_threads);
+  for (thread &worker : threads) worker.join();
+}
+
+}  // namespace
+
+size_t NextPowerOfTwo(size_t n) {
+  size_t power = 1;
+  while (power < n) power <<= 1;
+  return power;
+}
+
+FftPlan::FftPlan(size_t size) : size_{size} {
+  if (size == 0 || (size & (size - 1)) != 0) abort();
+  twiddles_.resize(size / 2);
+  for (size_t k = 0; k < size / 2; ++k)
+    twiddles_[k] = polar(1.0, -2.0 * kPi * k / size);
+  for (size_t i = 1, j = 0; i < size; ++i) {
+    // j is i with its bits reversed, advanced by a reversed increment.
+    size_t bit = size >> 1;
+    for (; j & bit; bit >>= 1) j ^= bit;
+    j ^= bit;
+    if (i < j) swaps_.emplace_back(i, j);
+  }
+}
+
+void FftPlan::Transform(complex<double> *data, bool inverse) const {
+  for (const pair<size_t, size_t> &indices : swaps_) swap(data[indices.first], data[indices.second]);
+  // Iterative Cooley-Tukey butterflies on blocks of length 2, 4, ...
+  for (size_t length = 2; length <= size_; length <<= 1) {
+    const size_t half = length / 2;
+    const size_t stride = size_ / length;
+    for (size_t start = 0; start < size_; start += length) {
+      for (size_t k = 0; k < half; ++k) {
+        const complex<double> twiddle =
+            inverse ? conj(twiddles_[k * stride]) : twiddles_[k * stride];
+        const complex<double> odd = data[start + k + half] * twiddle;
+        data[start + k + half] = data[start + k] - odd;
+        data[start + k] += odd;
+      }
+    }
+  }
+  if (inverse) {
+    const double scale = 1.0 / size_;
+    for (size_t k = 0; k < size_; ++k) data[k] *= scale;
+  }
+}
+
+void Fft2d(vector<complex<double>> *data, size_t num_rows, size_t num_columns, bool inverse,
+           int num_threads) {
+  if (data == nullptr || data->size() != num_rows * num_columns) abort();
+  if (data->empty()) return;
+  const FftPlan row_plan(num_columns);
+  const FftPlan column_plan(num_rows);
+  complex<double> *values = data->data();
+
+  ParallelFor(num_rows, num_threads, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) row_plan.Transform(values + i * num_columns, inverse);
+  });
+
+  // Columns in blocks: gather a block of columns into contiguous
+  // buffers, transform them and scatter them back.
+  const size_t num_blocks = (num_columns + kColumnBlock - 1) / kColumnBlock;
+  ParallelFor(num_blocks, num_threads, [&](size_t begin, size_t end) {
+    vector<complex<double>> buffer(kColumnBlock * num_rows);
+    for (size_t block = begin; block < end; ++block) {
+      const size_t first = block * kColumnBlock;
+      const size_t width = min(kColumnBlock, num_columns - first);
+      for (size_t i = 0; i < num_rows; ++i)
+        for (size_t c = 0; c < width; ++c)
+          buffer[c * num_rows + i] = values[i * num_columns + first + c];
+      for (size_t c = 0; c < width; ++c) column_plan.Transform(&buffer[c * num_rows], inverse);
+      for (size_t i = 0; i < num_rows; ++i)
+        for (size_t c = 0; c < width; ++c)
+          values[i * num_columns + first + c] = buffer[c * num_rows + i];
+    }
+  });
+}
+
+}  // namespace ComputerVisionProjects
@@ -0,0 +1,55 @@
+// Name: Kevin Fang
+// Radix-2 fast Fourier transforms of complex data, in 1-D and 2-D.
+// Sizes must be powers of two; pad with NextPowerOfTwo().
+
+#ifndef COMPUTER_VISION_FFT_H_
+#define COMPUTER_VISION_FFT_H_
+
+#include <complex>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+namespace ComputerVisionProjects {
+
+// Smallest power of two that is at least n (1 for n = 0).
+size_t NextPowerOfTwo(size_t n);
+
+// Twiddle factors and bit-reversal order for transforms of one size,
+// computed once and shared (Transform() is const, so one plan can be
+// used by several threads at the same time).
+// Sample usage:
+//   FftPlan plan(256);
+//   plan.Transform(values.data(), false);  // Forward.
+//   plan.Transform(values.data(), true);   // Back to values.
+class FftPlan {
+ public:
+  // size must be a power of two.
+  explicit FftPlan(size_t size);
+
+  size_t size() const { return size_; }
+
+  // In-place transform of size() values. The forward transform is
+  //   X[k] = sum_n x[n] exp(-2 pi i k n / size);
+  // the inverse one uses exp(+2 pi i k n / size) and divides by size,
+  // so it undoes the forward one.
+  void Transform(std::complex<double> *data, bool inverse) const;
+
+ private:
+  size_t size_;
+  // exp(-2 pi i k / size) for k < size / 2.
+  std::vector<std::complex<double>> twiddles_;
+  // Pairs (i, j), i < j, swapped by the bit-reversal permutation.
+  std::vector<std::pair<size_t, size_t>> swaps_;
+};
+
+// In-place 2-D transform of data (num_rows x num_columns, row-major,
+// both powers of two): every row, then every column. Rows and columns
+// are split among num_threads threads (0 means one per hardware
+// thread).
+void Fft2d(std::vector<std::complex<double>> *data, size_t num_rows, size_t num_columns,
+           bool inverse, int num_threads);
+
+}  // namespace ComputerVisionProjects
+
+#endif  // COMPUTER_VISION_FFT_H_
@@ -0,0 +1,129 @@
+// Name: Kevin Fang
+// Float images (1 or 3 channels) with reading/writing of PFM files, so
+// results like normal maps and albedo keep their full precision between
+// programs.
+
+#include "float_image.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+
+namespace ComputerVisionProjects {
+
+namespace {
+
+bool IsLittleEndian() {
+  const unsigned int one = 1;
+  unsigned char first;
+  memcpy(&first, &one, 1);
+  return first == 1;
+}
+
+// Reads the next whitespace-separated header token, and the one
+// whitespace character after it (after the scale, that ends the header).
+bool ReadToken(FILE *input, char *token, int size) {
+  int c;
+  do {
+    c = fgetc(input);
+  } while (c == ' ' || c == '\t' || c == '\n' || c == '\r');
+  int length = 0;
+  while (c != EOF && c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+    if (length + 1 < size) token[length++] = c;
+    c = fgetc(input);
+  }
+  token[length] = '\0';
+  return length > 0;
+}
+
+}  // namespace
+
+void FloatImage::AllocateSpaceAndSetSize(size_t rows, size_t columns, int channels) {
+  if (channels != 1 && channels != 3) abort();
+  num_rows = rows;
+  num_columns = columns;
+  num_channels = channels;
+  pixels.assign(rows * columns * channels, 0.0f);
+}
+
+bool ReadPfm(const string &filename, FloatImage *an_image) {
+  if (an_image == nullptr) abort();
+  FILE *input = fopen(filename.c_str(), "rb");
+  if (input == nullptr) {
+    cout << "ReadPfm: cannot open file" << endl;
+    return false;
+  }
+
+  char magic[8], width[32], height[32], scale[64];
+  if (!ReadToken(input, magic, sizeof magic) || (strcmp(magic, "Pf") && strcmp(magic, "PF")) ||
+      !ReadToken(input, width, sizeof width) || !ReadToken(input, height, sizeof height) ||
+      !ReadToken(input, scale, sizeof scale)) {
+    fclose(input);
+    cout << "ReadPfm: Expected .pfm file" << endl;
+    return false;
+  }
+  const int num_columns = atoi(width);
+  const int num_rows = atoi(height);
+  if (num_columns < 0 || num_rows < 0) {
+    fclose(input);
+    cout << "ReadPfm: bad size" << endl;
+    return false;
+  }
+  // A negative scale means little-endian floats.
+  const bool swap_bytes = (atof(scale) < 0) != IsLittleEndian();
+  an_image->AllocateSpaceAndSetSize(num_rows, num_columns, magic[1] == 'F' ? 3 : 1);
+
+  const size_t row_floats = num_columns * an_image->num_channels;
+  for (int i = num_rows - 1; i >= 0; --i) {
+    float *row = an_image->pixels.data() + i * row_floats;
+    if (fread(row, sizeof(float), row_floats, input) != row_floats) {
+      fclose(input);
+      cout << "ReadPfm: short file" << endl;
+      return false;
+    }
+    if (!swap_bytes) continue;
+    for (size_t k = 0; k < row_floats; ++k) {
+      unsigned char *bytes = reinterpret_cast<unsigned char *>(&row[k]);
+      swap(bytes[0], bytes[3]);
+      swap(bytes[1], bytes[2]);
+    }
+  }
+
+  fclose(input);
+  return true;
+}
+
+bool WritePfm(const string &filename, const FloatImage &an_image) {
+  if (an_image.num_channels != 1 && an_image.num_channels != 3) abort();
+  FILE *output = fopen(filename.c_str(), "wb");
+  if (output == nullptr) {
+    cout << "WritePfm: cannot open file" << endl;
+    return false;
+  }
+  fprintf(output, "%s\n%zu %zu\n%s\n", an_image.num_channels == 3 ? "PF" : "Pf",
+          an_image.num_columns, an_image.num_rows, IsLittleEndian() ? "-1.0" : "1.0");
+
+  const size_t row_floats = an_image.num_columns * an_image.num_channels;
+  for (size_t i = an_image.num_rows; i-- > 0;) {
+    if (fwrite(an_image.pixels.data() + i * row_floats, sizeof(float), row_floats, output) !=
+        row_floats) {
+      fclose(output);
+      cout << "WritePfm: could not write" << endl;
+      return false;
+    }
+  }
+
+  fclose(output);
+  return true;
+}
+
+bool IsPfmFilename(const string &filename) {
+  const string extension = ".pfm";
+  return filename.size() >= extension.size() &&
+         filename.compare(filename.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+}  // namespace ComputerVisionProjects
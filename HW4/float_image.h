@@ -0,0 +1,56 @@
+// Name: Kevin Fang
+// Float images (1 or 3 channels) with reading/writing of PFM files, so
+// results like normal maps and albedo keep their full precision between
+// programs.
+
+#ifndef COMPUTER_VISION_FLOAT_IMAGE_H_
+#define COMPUTER_VISION_FLOAT_IMAGE_H_
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace ComputerVisionProjects {
+
+// A float image with num_channels (1 or 3) interleaved channels per
+// pixel, stored row by row with row 0 at the top.
+// Sample usage:
+//   FloatImage normals;
+//   normals.AllocateSpaceAndSetSize(rows, columns, 3);
+//   normals.at(i, j, 2) = 1.0f;
+//   WritePfm("normals.pfm", normals);
+struct FloatImage {
+  size_t num_rows = 0;
+  size_t num_columns = 0;
+  int num_channels = 1;
+  std::vector<float> pixels;
+
+  // Sets the size and fills every channel of every pixel with 0.
+  void AllocateSpaceAndSetSize(size_t rows, size_t columns, int channels);
+
+  float &at(size_t i, size_t j, int channel) {
+    return pixels[(i * num_columns + j) * num_channels + channel];
+  }
+  float at(size_t i, size_t j, int channel) const {
+    return pixels[(i * num_columns + j) * num_channels + channel];
+  }
+};
+
+// Reads a PFM file ("Pf" for 1 channel, "PF" for 3) into an_image,
+// converting the floats to the byte order of this machine.
+// Returns true if everything is OK, false otherwise.
+bool ReadPfm(const std::string &filename, FloatImage *an_image);
+
+// Writes an_image (1 or 3 channels) as a PFM file in the byte order of
+// this machine. As PFM requires, rows are stored bottom to top; the
+// floats follow the text header directly, so the payload can be read
+// (or mapped) in one piece.
+// Returns true if everything is OK, false otherwise.
+bool WritePfm(const std::string &filename, const FloatImage &an_image);
+
+// Returns true if filename ends with ".pfm".
+bool IsPfmFilename(const std::string &filename);
+
+}  // namespace ComputerVisionProjects
+
+#endif  // COMPUTER_VISION_FLOAT_IMAGE_H_
@@ -50,6 +50,12 @@ class Image {
     pixels_[i][j] = gray_level;
   }
 
+  // Same as SetPixel() without the bounds check, for inner loops whose
+  // coordinates are already known to be inside the image.
+  void SetPixelUnchecked(size_t i, size_t j, int gray_level) {
+    pixels_[i][j] = gray_level;
+  }
+
   int GetPixel(size_t i, size_t j) const {
     if (i >= num_rows_ || j >= num_columns_) abort();
     return pixels_[i][j];
@@ -0,0 +1,138 @@
+// Name: Kevin Fang
+// Needle maps of surface normals: the needles as line segments, drawn
+// into an image with clipped, batched line rasterization, or written as
+// an SVG overlay of the object image.
+
+#include "needle_map.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+
+namespace ComputerVisionProjects {
+
+namespace {
+
+// Bresenham from (x0, y0) to (x1, y1), both inside an_image.
+void DrawInsideLine(int x0, int y0, int x1, int y1, int color, Image *an_image) {
+  const int dx = abs(x1 - x0), dy = -abs(y1 - y0);
+  const int step_x = (x0 < x1) ? 1 : -1, step_y = (y0 < y1) ? 1 : -1;
+  int error = dx + dy;
+  while (true) {
+    an_image->SetPixelUnchecked(y0, x0, color);
+    if (x0 == x1 && y0 == y1) break;
+    const int twice = 2 * error;
+    if (twice >= dy) {
+      error += dy;
+      x0 += step_x;
+    }
+    if (twice <= dx) {
+      error += dx;
+      y0 += step_y;
+    }
+  }
+}
+
+}  // namespace
+
+bool ClipSegment(double x_max, double y_max, LineSegment *segment) {
+  if (segment == nullptr) abort();
+  const double dx = segment->x1 - segment->x0;
+  const double dy = segment->y1 - segment->y0;
+  // The segment is x0 + t dx, y0 + t dy for t in [0, 1]; each edge of the
+  // rectangle p t <= q narrows that range.
+  const double p[4] = {-dx, dx, -dy, dy};
+  const double q[4] = {segment->x0, x_max - segment->x0, segment->y0, y_max - segment->y0};
+  double t_enter = 0, t_leave = 1;
+  for (int k = 0; k < 4; ++k) {
+    if (p[k] == 0) {
+      if (q[k] < 0) return false;  // Parallel to this edge and outside.
+      continue;
+    }
+    const double t = q[k] / p[k];
+    if (p[k] < 0)
+      t_enter = max(t_enter, t);
+    else
+      t_leave = min(t_leave, t);
+    if (t_enter > t_leave) return false;
+  }
+  const double x0 = segment->x0, y0 = segment->y0;
+  segment->x0 = x0 + t_enter * dx;
+  segment->y0 = y0 + t_enter * dy;
+  segment->x1 = x0 + t_leave * dx;
+  segment->y1 = y0 + t_leave * dy;
+  return true;
+}
+
+void DrawLines(const vector<LineSegment> &segments, int color, Image *an_image) {
+  if (an_image == nullptr) abort();
+  if (an_image->num_rows() == 0 || an_image->num_columns() == 0) return;
+  const double x_max = an_image->num_columns() - 1;
+  const double y_max = an_image->num_rows() - 1;
+  for (LineSegment segment : segments) {
+    if (!ClipSegment(x_max, y_max, &segment)) continue;
+    // Rounding keeps the ends inside the image, and so the whole line.
+    DrawInsideLine(lround(segment.x0), lround(segment.y0), lround(segment.x1),
+                   lround(segment.y1), color, an_image);
+  }
+}
+
+void NeedleSegments(const SurfaceMaps &maps, int step, double length,
+                    vector<LineSegment> *needles) {
+  if (needles == nullptr || step <= 0) abort();
+  needles->clear();
+  for (size_t y = 0; y < maps.num_rows; y += step) {
+    for (size_t x = 0; x < maps.num_columns; x += step) {
+      const size_t index = y * maps.num_columns + x;
+      if (maps.albedo[index] <= 0) continue;
+      needles->push_back({static_cast<double>(x), static_cast<double>(y),
+                          x + length * maps.normal_x[index], y + length * maps.normal_y[index]});
+    }
+  }
+}
+
+void DrawNeedles(const vector<LineSegment> &needles, Image *an_image) {
+  if (an_image == nullptr) abort();
+  DrawLines(needles, 255, an_image);
+  // Needles start at pixel centers inside the image.
+  for (const LineSegment &needle : needles)
+    an_image->SetPixel(static_cast<size_t>(needle.y0), static_cast<size_t>(needle.x0), 0);
+}
+
+bool WriteNeedleSvg(const string &filename, const vector<LineSegment> &needles, size_t num_rows,
+                    size_t num_columns) {
+  ofstream output(filename);
+  if (!output.is_open()) {
+    cout << "WriteNeedleSvg: cannot open file" << endl;
+    return false;
+  }
+  output << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << num_columns << "\" height=\""
+         << num_rows << "\" viewBox=\"0 0 " << num_columns << " " << num_rows << "\">\n";
+  // One path for all the needles keeps the file small and fast to render.
+  // Pixel (x, y) is the unit square whose center is (x + 0.5, y + 0.5).
+  output << "<path stroke=\"red\" stroke-width=\"0.5\" fill=\"none\" d=\"";
+  output.precision(2);
+  output << fixed;
+  for (const LineSegment &needle : needles) {
+    output << "M" << needle.x0 + 0.5 << " " << needle.y0 + 0.5 << "L" << needle.x1 + 0.5 << " "
+           << needle.y1 + 0.5;
+  }
+  output << "\"/>\n</svg>\n";
+  if (!output) {
+    cout << "WriteNeedleSvg: could not write" << endl;
+    return false;
+  }
+  return true;
+}
+
+bool IsSvgFilename(const string &filename) {
+  const string extension = ".svg";
+  return filename.size() >= extension.size() &&
+         filename.compare(filename.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+}  // namespace ComputerVisionProjects
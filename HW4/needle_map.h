@@ -0,0 +1,56 @@
+// Name: Kevin Fang
+// Needle maps of surface normals: the needles as line segments, drawn
+// into an image with clipped, batched line rasterization, or written as
+// an SVG overlay of the object image.
+
+#ifndef COMPUTER_VISION_NEEDLE_MAP_H_
+#define COMPUTER_VISION_NEEDLE_MAP_H_
+
+#include <string>
+#include <vector>
+
+#include "image.h"
+#include "photometric_stereo.h"
+
+namespace ComputerVisionProjects {
+
+// A line segment in image coordinates (x is the column, y the row).
+struct LineSegment {
+  double x0;
+  double y0;
+  double x1;
+  double y1;
+};
+
+// Clips the segment to the rectangle [0, x_max] x [0, y_max]
+// (Liang-Barsky). Returns false if nothing of it is inside.
+bool ClipSegment(double x_max, double y_max, LineSegment *segment);
+
+// Draws every segment with the given gray level. Segments are clipped
+// to the image first, so they may start or end outside of it; the
+// pixels are then set without bounds checks.
+void DrawLines(const std::vector<LineSegment> &segments, int color, Image *an_image);
+
+// One needle every step pixels where the albedo is positive: from the
+// pixel along the (x, y) part of its normal, length pixels long for a
+// normal in the image plane.
+void NeedleSegments(const SurfaceMaps &maps, int step, double length,
+                    std::vector<LineSegment> *needles);
+
+// Draws needles on an_image in white, with a black dot at the pixel of
+// each normal.
+void DrawNeedles(const std::vector<LineSegment> &needles, Image *an_image);
+
+// Writes the needles as an SVG image of num_columns x num_rows pixels
+// with a transparent background, so it can be laid over the object image
+// at any zoom without rewriting the image itself.
+// Returns true if everything is OK, false otherwise.
+bool WriteNeedleSvg(const std::string &filename, const std::vector<LineSegment> &needles,
+                    size_t num_rows, size_t num_columns);
+
+// True if filename ends in .svg.
+bool IsSvgFilename(const std::string &filename);
+
+}  // namespace ComputerVisionProjects
+
+#endif  // COMPUTER_VISION_NEEDLE_MAP_H_
@@ -0,0 +1,326 @@
+// Name: Kevin Fang
+// Photometric stereo: surface normals and albedo of every pixel from
+// images of the same object lit from N >= 3 known directions, solved in
+// the least-squares sense with the pseudo-inverse of the light matrix.
+// Intensities are read as planar 8-bit arrays and solved four pixels at
+// a time with SSE (with a scalar fallback on other targets).
+
+#include "photometric_stereo.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "needle_map.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+namespace ComputerVisionProjects {
+
+namespace {
+
+// Solves pixel p one at a time (image edges and non-SSE targets).
+inline void SolvePixel(const unsigned char *const *planes, int num_lights, const float *inverse,
+                       size_t p, int threshold, float *normal_x, float *normal_y,
+                       float *normal_z, float *albedo) {
+  float g[3] = {0, 0, 0};
+  bool lit = true;
+  for (int k = 0; k < num_lights; ++k) {
+    const int intensity = planes[k][p];
+    lit = lit && intensity > threshold;
+    for (int r = 0; r < 3; ++r) g[r] += inverse[r * num_lights + k] * intensity;
+  }
+  const float length2 = g[0] * g[0] + g[1] * g[1] + g[2] * g[2];
+  const float scale = (lit && length2 > 0) ? 1.0f / sqrt(length2) : 0.0f;
+  normal_x[p] = g[0] * scale;
+  normal_y[p] = g[1] * scale;
+  normal_z[p] = g[2] * scale;
+  albedo[p] = length2 * scale;
+}
+
+// Pseudo-inverse (S^T S)^-1 S^T of the lights in mask into inverse
+// (3 x num_lights, zero columns for the lights left out).
+// Returns false if they are fewer than 3 or don't span 3-D.
+bool PseudoInverse(const vector<LightDirection> &directions, unsigned mask, float *inverse) {
+  const int num_lights = directions.size();
+  double a[3][3] = {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}};
+  int count = 0;
+  for (int k = 0; k < num_lights; ++k) {
+    if (!(mask >> k & 1)) continue;
+    ++count;
+    for (int r = 0; r < 3; ++r)
+      for (int c = 0; c < 3; ++c) a[r][c] += directions[k][r] * directions[k][c];
+  }
+  if (count < 3) return false;
+
+  // S^T S is symmetric positive semi-definite; it is singular in
+  // practice when its determinant is tiny next to its scale.
+  const double det = a[0][0] * (a[1][1] * a[2][2] - a[1][2] * a[2][1]) -
+                     a[0][1] * (a[1][0] * a[2][2] - a[1][2] * a[2][0]) +
+                     a[0][2] * (a[1][0] * a[2][1] - a[1][1] * a[2][0]);
+  const double scale = (a[0][0] + a[1][1] + a[2][2]) / 3.0;
+  if (!(det > 1e-9 * scale * scale * scale)) return false;
+  const double inv_det = 1.0 / det;
+  double b[3][3];
+  b[0][0] = (a[1][1] * a[2][2] - a[1][2] * a[2][1]) * inv_det;
+  b[0][1] = -(a[0][1] * a[2][2] - a[0][2] * a[2][1]) * inv_det;
+  b[0][2] = (a[0][1] * a[1][2] - a[0][2] * a[1][1]) * inv_det;
+  b[1][0] = -(a[1][0] * a[2][2] - a[1][2] * a[2][0]) * inv_det;
+  b[1][1] = (a[0][0] * a[2][2] - a[0][2] * a[2][0]) * inv_det;
+  b[1][2] = -(a[0][0] * a[1][2] - a[0][2] * a[1][0]) * inv_det;
+  b[2][0] = (a[1][0] * a[2][1] - a[1][1] * a[2][0]) * inv_det;
+  b[2][1] = -(a[0][0] * a[2][1] - a[0][1] * a[2][0]) * inv_det;
+  b[2][2] = (a[0][0] * a[1][1] - a[0][1] * a[1][0]) * inv_det;
+
+  for (int r = 0; r < 3; ++r) {
+    for (int k = 0; k < num_lights; ++k) {
+      double value = 0;
+      if (mask >> k & 1)
+        for (int c = 0; c < 3; ++c) value += b[r][c] * directions[k][c];
+      inverse[r * num_lights + k] = value;
+    }
+  }
+  return true;
+}
+
+// Checks the planes against the lights and the size, and returns
+// pointers to them.
+vector<const unsigned char *> PlanePointers(const vector<vector<unsigned char>> &planes,
+                                            const LightSet &lights, size_t num_pixels) {
+  if (static_cast<int>(planes.size()) != lights.num_lights()) abort();
+  vector<const unsigned char *> pointers;
+  for (const vector<unsigned char> &plane : planes) {
+    if (plane.size() != num_pixels) abort();
+    pointers.push_back(plane.data());
+  }
+  return pointers;
+}
+
+#ifdef __SSE2__
+// Loads four consecutive 8-bit values as floats.
+inline __m128 LoadFour(const unsigned char *values) {
+  int bits;
+  memcpy(&bits, values, sizeof bits);
+  const __m128i zero = _mm_setzero_si128();
+  __m128i wide = _mm_unpacklo_epi8(_mm_cvtsi32_si128(bits), zero);
+  wide = _mm_unpacklo_epi16(wide, zero);
+  return _mm_cvtepi32_ps(wide);
+}
+#endif
+
+}  // namespace
+
+void SurfaceMaps::Resize(size_t rows, size_t columns) {
+  num_rows = rows;
+  num_columns = columns;
+  normal_x.assign(rows * columns, 0.0f);
+  normal_y.assign(rows * columns, 0.0f);
+  normal_z.assign(rows * columns, 0.0f);
+  albedo.assign(rows * columns, 0.0f);
+}
+
+void SurfaceMapsToFloatImages(const SurfaceMaps &maps, FloatImage *normals, FloatImage *albedo) {
+  if (normals == nullptr || albedo == nullptr) abort();
+  const size_t num_pixels = maps.num_rows * maps.num_columns;
+  normals->AllocateSpaceAndSetSize(maps.num_rows, maps.num_columns, 3);
+  albedo->AllocateSpaceAndSetSize(maps.num_rows, maps.num_columns, 1);
+  for (size_t p = 0; p < num_pixels; ++p) {
+    normals->pixels[3 * p] = maps.normal_x[p];
+    normals->pixels[3 * p + 1] = maps.normal_y[p];
+    normals->pixels[3 * p + 2] = maps.normal_z[p];
+  }
+  albedo->pixels = maps.albedo;
+}
+
+bool WriteSurfaceMaps(const string &normals_filename, const string &albedo_filename,
+                      const SurfaceMaps &maps, const Image &background, int step) {
+  if (step <= 0 || background.num_rows() != maps.num_rows ||
+      background.num_columns() != maps.num_columns)
+    abort();
+  FloatImage normal_map, albedo_map;
+  if (IsPfmFilename(normals_filename) || IsPfmFilename(albedo_filename))
+    SurfaceMapsToFloatImages(maps, &normal_map, &albedo_map);
+
+  if (IsPfmFilename(normals_filename)) {
+    if (!WritePfm(normals_filename, normal_map)) return false;
+  } else {
+    vector<LineSegment> needles;
+    NeedleSegments(maps, step, 10.0, &needles);
+    if (IsSvgFilename(normals_filename)) {
+      if (!WriteNeedleSvg(normals_filename, needles, maps.num_rows, maps.num_columns))
+        return false;
+    } else {
+      Image needle_image(background);
+      DrawNeedles(needles, &needle_image);
+      if (!WriteImage(normals_filename, needle_image)) return false;
+    }
+  }
+
+  if (IsPfmFilename(albedo_filename)) return WritePfm(albedo_filename, albedo_map);
+  float max_albedo = 0.0f;
+  for (const float albedo : maps.albedo) max_albedo = max(max_albedo, albedo);
+  Image scaled;
+  scaled.AllocateSpaceAndSetSize(maps.num_rows, maps.num_columns);
+  scaled.SetNumberGrayLevels(255);
+  for (size_t y = 0; y < maps.num_rows; ++y) {
+    for (size_t x = 0; x < maps.num_columns; ++x) {
+      const double albedo = maps.albedo[y * maps.num_columns + x];
+      scaled.SetPixel(y, x, max_albedo > 0 ? static_cast<int>(albedo / max_albedo * 255.0) : 0);
+    }
+  }
+  return WriteImage(albedo_filename, scaled);
+}
+
+bool ReadLightDirections(const string &filename, vector<LightDirection> *directions) {
+  if (directions == nullptr) abort();
+  ifstream input(filename);
+  if (!input.is_open()) {
+    cout << "ReadLightDirections: cannot open file" << endl;
+    return false;
+  }
+  directions->clear();
+  string line;
+  while (getline(input, line)) {
+    if (line.find_first_not_of(" \t\r") == string::npos) continue;
+    istringstream values(line);
+    LightDirection direction;
+    if (!(values >> direction[0] >> direction[1] >> direction[2])) {
+      cout << "ReadLightDirections: bad line: " << line << endl;
+      return false;
+    }
+    directions->push_back(direction);
+  }
+  return true;
+}
+
+bool LightSet::Set(const vector<LightDirection> &directions) {
+  directions_ = directions;
+  subset_inverses_.clear();
+  subset_usable_.clear();
+  const int n = directions_.size();
+  if (n < 3 || n > kMaxLights) return false;
+  pseudo_inverse_.assign(3 * n, 0.0f);
+  const unsigned all = (n < 32) ? (1u << n) - 1 : ~0u;
+  if (!PseudoInverse(directions_, all, pseudo_inverse_.data())) return false;
+
+  if (n <= kMaxSubsetLights) {
+    subset_inverses_.assign((size_t{1} << n) * 3 * n, 0.0f);
+    subset_usable_.assign(size_t{1} << n, 0);
+    for (unsigned mask = 0; mask <= all; ++mask)
+      subset_usable_[mask] = PseudoInverse(directions_, mask, &subset_inverses_[mask * 3 * n]);
+  }
+  return true;
+}
+
+const float *LightSet::SubsetInverse(unsigned mask) const {
+  if (mask >= subset_usable_.size() || !subset_usable_[mask]) return nullptr;
+  return &subset_inverses_[mask * 3 * directions_.size()];
+}
+
+void ImageToPlane(const Image &an_image, vector<unsigned char> *plane) {
+  if (plane == nullptr) abort();
+  const size_t rows = an_image.num_rows();
+  const size_t cols = an_image.num_columns();
+  plane->resize(rows * cols);
+  for (size_t i = 0; i < rows; ++i)
+    for (size_t j = 0; j < cols; ++j)
+      (*plane)[i * cols + j] = min(max(an_image.GetPixel(i, j), 0), 255);
+}
+
+void SolveNormals(const unsigned char *const *planes, int num_lights, const float *inverse,
+                  size_t num_pixels, int threshold, float *normal_x, float *normal_y,
+                  float *normal_z, float *albedo) {
+  size_t p = 0;
+#ifdef __SSE2__
+  // Four pixels per step. The threshold test and the zero-length test
+  // become a mask that zeroes the reciprocal length, so unlit pixels
+  // need no branch. The approximate reciprocal square root (12 bits) is
+  // refined with one Newton step: r' = r (1.5 - 0.5 x r^2).
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 limit = _mm_set1_ps(static_cast<float>(threshold));
+  const __m128 half = _mm_set1_ps(0.5f);
+  const __m128 three_halves = _mm_set1_ps(1.5f);
+  for (; p + 4 <= num_pixels; p += 4) {
+    __m128 gx = zero, gy = zero, gz = zero;
+    __m128 lit = _mm_cmpeq_ps(zero, zero);
+    for (int k = 0; k < num_lights; ++k) {
+      const __m128 intensity = LoadFour(planes[k] + p);
+      lit = _mm_and_ps(lit, _mm_cmpgt_ps(intensity, limit));
+      gx = _mm_add_ps(gx, _mm_mul_ps(_mm_set1_ps(inverse[k]), intensity));
+      gy = _mm_add_ps(gy, _mm_mul_ps(_mm_set1_ps(inverse[num_lights + k]), intensity));
+      gz = _mm_add_ps(gz, _mm_mul_ps(_mm_set1_ps(inverse[2 * num_lights + k]), intensity));
+    }
+    const __m128 length2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(gx, gx), _mm_mul_ps(gy, gy)),
+                                      _mm_mul_ps(gz, gz));
+    lit = _mm_and_ps(lit, _mm_cmpgt_ps(length2, zero));
+    __m128 scale = _mm_rsqrt_ps(length2);
+    scale = _mm_mul_ps(scale, _mm_sub_ps(three_halves,
+                                         _mm_mul_ps(_mm_mul_ps(half, length2),
+                                                    _mm_mul_ps(scale, scale))));
+    scale = _mm_and_ps(scale, lit);
+    _mm_storeu_ps(normal_x + p, _mm_mul_ps(gx, scale));
+    _mm_storeu_ps(normal_y + p, _mm_mul_ps(gy, scale));
+    _mm_storeu_ps(normal_z + p, _mm_mul_ps(gz, scale));
+    _mm_storeu_ps(albedo + p, _mm_mul_ps(length2, scale));
+  }
+#endif
+  for (; p < num_pixels; ++p)
+    SolvePixel(planes, num_lights, inverse, p, threshold, normal_x, normal_y, normal_z, albedo);
+}
+
+void SolveNormalsDroppingOutliers(const unsigned char *const *planes, const LightSet &lights,
+                                  size_t num_pixels, int threshold, int saturation,
+                                  float *normal_x, float *normal_y, float *normal_z,
+                                  float *albedo) {
+  if (!lights.has_subsets()) abort();
+  const int num_lights = lights.num_lights();
+  for (size_t p = 0; p < num_pixels; ++p) {
+    unsigned mask = 0;
+    for (int k = 0; k < num_lights; ++k) {
+      const int intensity = planes[k][p];
+      if (intensity > threshold && intensity < saturation) mask |= 1u << k;
+    }
+    const float *inverse = lights.SubsetInverse(mask);
+    if (inverse == nullptr) {
+      normal_x[p] = normal_y[p] = normal_z[p] = albedo[p] = 0.0f;
+      continue;
+    }
+    // The lights left out have zero columns, so their intensities don't
+    // count, and every intensity passes a threshold of -1.
+    SolvePixel(planes, num_lights, inverse, p, -1, normal_x, normal_y, normal_z, albedo);
+  }
+}
+
+void ComputeSurfaceMaps(const vector<vector<unsigned char>> &planes, const LightSet &lights,
+                        size_t num_rows, size_t num_columns, int threshold,
+                        SurfaceMaps *maps) {
+  if (maps == nullptr) abort();
+  maps->Resize(num_rows, num_columns);
+  const size_t num_pixels = num_rows * num_columns;
+  const vector<const unsigned char *> pointers = PlanePointers(planes, lights, num_pixels);
+  SolveNormals(pointers.data(), lights.num_lights(), lights.pseudo_inverse(), num_pixels,
+               threshold, maps->normal_x.data(), maps->normal_y.data(),
+               maps->normal_z.data(), maps->albedo.data());
+}
+
+void ComputeSurfaceMapsDroppingOutliers(const vector<vector<unsigned char>> &planes,
+                                        const LightSet &lights, size_t num_rows,
+                                        size_t num_columns, int threshold, int saturation,
+                                        SurfaceMaps *maps) {
+  if (maps == nullptr) abort();
+  maps->Resize(num_rows, num_columns);
+  const size_t num_pixels = num_rows * num_columns;
+  const vector<const unsigned char *> pointers = PlanePointers(planes, lights, num_pixels);
+  SolveNormalsDroppingOutliers(pointers.data(), lights, num_pixels, threshold, saturation,
+                               maps->normal_x.data(), maps->normal_y.data(),
+                               maps->normal_z.data(), maps->albedo.data());
+}
+
+}  // namespace ComputerVisionProjects
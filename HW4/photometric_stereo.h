@@ -0,0 +1,138 @@
+// Name: Kevin Fang
+// Photometric stereo: surface normals and albedo of every pixel from
+// images of the same object lit from N >= 3 known directions, solved in
+// the least-squares sense with the pseudo-inverse of the light matrix.
+// Intensities are read as planar 8-bit arrays and solved four pixels at
+// a time with SSE (with a scalar fallback on other targets).
+
+#ifndef COMPUTER_VISION_PHOTOMETRIC_STEREO_H_
+#define COMPUTER_VISION_PHOTOMETRIC_STEREO_H_
+
+#include <array>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "float_image.h"
+#include "image.h"
+
+namespace ComputerVisionProjects {
+
+// Unit normals and albedo as float planes (num_rows x num_columns,
+// row-major). Pixels that can't be solved (not lit in enough images)
+// have a zero normal and albedo.
+struct SurfaceMaps {
+  size_t num_rows = 0;
+  size_t num_columns = 0;
+  std::vector<float> normal_x;
+  std::vector<float> normal_y;
+  std::vector<float> normal_z;
+  std::vector<float> albedo;
+
+  void Resize(size_t rows, size_t columns);
+};
+
+// Copies the normals into a 3-channel float image (x, y, z per pixel)
+// and the albedo into a 1-channel one, e.g. to write them as PFM files.
+void SurfaceMapsToFloatImages(const SurfaceMaps &maps, FloatImage *normals, FloatImage *albedo);
+
+// Writes the normals as needles (every step pixels, 10 pixels long, on a
+// copy of background; see needle_map.h) and the albedo scaled so the
+// largest one is 255, as s3 always did. A filename ending in .pfm gets
+// the float image of SurfaceMapsToFloatImages() instead, and a normals
+// filename ending in .svg gets the needles alone as an SVG overlay.
+// Returns true if everything is OK, false otherwise.
+bool WriteSurfaceMaps(const std::string &normals_filename, const std::string &albedo_filename,
+                      const SurfaceMaps &maps, const Image &background, int step);
+
+// Light direction (x, y, z) scaled by the light's intensity.
+typedef std::array<double, 3> LightDirection;
+
+// Reads one light direction per line (as written by s2).
+// Returns true if everything is OK, false otherwise.
+bool ReadLightDirections(const std::string &filename, std::vector<LightDirection> *directions);
+
+// Largest number of lights (one bit each in a light mask).
+const int kMaxLights = 32;
+
+// Largest number of lights for which the pseudo-inverses of all light
+// subsets are cached (2^N of them).
+const int kMaxSubsetLights = 12;
+
+// The lights of a photometric stereo setup with the least-squares
+// solutions precomputed, so that no pixel needs a matrix solve.
+// Sample usage:
+//   LightSet lights;
+//   if (!lights.Set(directions)) ...
+//   SolveNormals(planes, lights.num_lights(), lights.pseudo_inverse(), ...);
+class LightSet {
+ public:
+  // Stores directions (one row of the light matrix S per light) and
+  // computes the pseudo-inverse (S^T S)^-1 S^T, which for 3 lights is
+  // the inverse of S. With at most kMaxSubsetLights lights the
+  // pseudo-inverse of every subset of 3 or more lights is computed too.
+  // Returns false with fewer than 3 or more than kMaxLights lights, or
+  // if they don't span 3-D.
+  bool Set(const std::vector<LightDirection> &directions);
+
+  int num_lights() const { return directions_.size(); }
+  const std::vector<LightDirection> &directions() const { return directions_; }
+
+  // 3 x num_lights, row-major.
+  const float *pseudo_inverse() const { return pseudo_inverse_.data(); }
+
+  bool has_subsets() const { return !subset_inverses_.empty(); }
+
+  // Pseudo-inverse using only the lights in mask (bit k is light k), as
+  // 3 x num_lights with zero columns for the other lights, so it can be
+  // multiplied with all the intensities of a pixel. Returns nullptr if
+  // those lights are fewer than 3 or don't span 3-D, or if subsets are
+  // not cached.
+  const float *SubsetInverse(unsigned mask) const;
+
+ private:
+  std::vector<LightDirection> directions_;
+  std::vector<float> pseudo_inverse_;
+  // 3 x num_lights floats per mask, and whether that subset is usable.
+  std::vector<float> subset_inverses_;
+  std::vector<unsigned char> subset_usable_;
+};
+
+// Copies the gray-levels of an_image into plane (row-major), clamped to
+// 0..255, so the solver can read them without per-pixel bounds checks.
+void ImageToPlane(const Image &an_image, std::vector<unsigned char> *plane);
+
+// Solves num_pixels pixels: with I the intensities of a pixel in the
+// num_lights planes, g = inverse * I (inverse is 3 x num_lights,
+// row-major), the albedo is |g| and the normal g / |g|. Pixels that are
+// not above threshold in every plane get zeros.
+void SolveNormals(const unsigned char *const *planes, int num_lights, const float *inverse,
+                  size_t num_pixels, int threshold, float *normal_x, float *normal_y,
+                  float *normal_z, float *albedo);
+
+// Like SolveNormals(), but a light is left out of a pixel's solution
+// when the pixel is shadowed (intensity <= threshold) or saturated
+// (intensity >= saturation) in its image, using the cached pseudo-
+// inverse of the remaining lights. Pixels with fewer than 3 usable
+// lights (or lights that don't span 3-D) get zeros. Pixels are solved
+// one at a time, since their matrices differ. lights must have subsets.
+void SolveNormalsDroppingOutliers(const unsigned char *const *planes, const LightSet &lights,
+                                  size_t num_pixels, int threshold, int saturation,
+                                  float *normal_x, float *normal_y, float *normal_z,
+                                  float *albedo);
+
+// Runs SolveNormals() over whole planes (num_rows x num_columns each,
+// one per light).
+void ComputeSurfaceMaps(const std::vector<std::vector<unsigned char>> &planes,
+                        const LightSet &lights, size_t num_rows, size_t num_columns,
+                        int threshold, SurfaceMaps *maps);
+
+// Runs SolveNormalsDroppingOutliers() over whole planes.
+void ComputeSurfaceMapsDroppingOutliers(const std::vector<std::vector<unsigned char>> &planes,
+                                        const LightSet &lights, size_t num_rows,
+                                        size_t num_columns, int threshold, int saturation,
+                                        SurfaceMaps *maps);
+
+}  // namespace ComputerVisionProjects
+
+#endif  // COMPUTER_VISION_PHOTOMETRIC_STEREO_H_
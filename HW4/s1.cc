@@ -10,14 +10,36 @@ Description:
     The radius is determined by averaging the horizontal and vertical extents of the circle
     and dividing by two.
 
+    Passing "edt" after the output file locates the sphere with the exact Euclidean distance
+    transform of the binary image (distance_transform.cc, through calibration.cc) instead:
+    the center is the pixel deepest inside the disc and the radius its distance to the
+    background, so specks and bright spots outside the sphere don't stretch the extents.
+
+    Passing "fit" after the output file fits a circle by least squares (Pratt's algebraic
+    fit, circle_fit.cc, through calibration.cc) to the boundary of the binary image, which
+    gives a sub-pixel center and radius from a single pass over the edges. Adding "ransac"
+    after "fit" leaves boundary points off the circle (stray foreground pixels) out of the fit.
+
+    Passing "hough" instead of a threshold value locates the sphere with the gradient-based
+    circle Hough transform (circle_hough.cc, through calibration.cc) instead, refined by a
+    least-squares fit to the rim edges. No threshold has to be tuned, and neither background
+    clutter nor the shading inside the sphere biases the result (within 0.3 pixels on the
+    synthetic spheres of sphere_check.cc). It takes no "edt" or "fit" after the output file.
+
 To run this program after compiling:
-    ./s1 <input gray-level sphere image> <threshold value> <output parameters file>
+    ./s1 <input gray-level sphere image> <threshold value> <output parameters file> [edt | fit [ransac]]
+    ./s1 <input gray-level sphere image> hough <output parameters file>
     Ex: ./s1 sphere0.pgm 100 parameters.txt
+    Ex: ./s1 sphere0.pgm 100 parameters.txt edt
+    Ex: ./s1 sphere0.pgm 100 parameters.txt fit ransac
+    Ex: ./s1 sphere0.pgm hough parameters.txt
 */
 #include "image.h"
+#include "calibration.h"
 #include <iostream>
 #include <fstream>
 #include <cmath>
+#include <vector>
 
 using namespace ComputerVisionProjects;
 
@@ -61,13 +83,20 @@ bool ThresholdImage(const Image &input_image, int threshold, Image *binary_image
 }
 
 int main(int argc, char *argv[]) {
-    if (argc != 4) {
-        std::cerr << "Usage: " << argv[0] << " {input gray-level sphere image} {threshold value} {output parameters file}\n";
+    const std::string locator = (argc > 4) ? argv[4] : "";
+    const bool ransac = (argc == 6 && std::string(argv[5]) == "ransac");
+    const bool hough = (argc > 2 && std::string(argv[2]) == "hough");
+    // The Hough transform has no threshold, so it can't be combined with
+    // the locators that work on the thresholded image.
+    if (!(argc == 4 || (argc == 5 && (locator == "edt" || locator == "fit")) ||
+          (locator == "fit" && ransac)) || (hough && argc != 4)) {
+        std::cerr << "Usage: " << argv[0] << " {input gray-level sphere image} {threshold value} {output parameters file} [edt | fit [ransac]]\n"
+                  << "       " << argv[0] << " {input gray-level sphere image} hough {output parameters file}\n";
         return 1;
     }
 
     const std::string input_filename(argv[1]);
-    const int threshold = std::stoi(argv[2]);
+    const std::string method(argv[2]);
     const std::string output_filename(argv[3]);
 
     Image input_image;
@@ -76,15 +105,40 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
-    Image binary_image;
-    if (!ThresholdImage(input_image, threshold, &binary_image)) {
-        std::cerr << "Error creating binary image\n";
-        return 1;
-    }
+    double x_center, y_center, radius;
+    if (method == "hough") {
+        Sphere sphere;
+        if (!LocateSphereByHough(input_image, &sphere)) {
+            std::cerr << "Error: no circle found in " << input_filename << "\n";
+            return 1;
+        }
+        x_center = sphere.x_center;
+        y_center = sphere.y_center;
+        radius = sphere.radius;
+    } else if (locator == "edt" || locator == "fit") {
+        Sphere sphere;
+        const bool located = (locator == "edt")
+            ? LocateSphereByDistance(input_image, std::stoi(method), &sphere)
+            : LocateSphereByFit(input_image, std::stoi(method), ransac, &sphere);
+        if (!located) {
+            std::cerr << "Error: no sphere found in " << input_filename << "\n";
+            return 1;
+        }
+        x_center = sphere.x_center;
+        y_center = sphere.y_center;
+        radius = sphere.radius;
+    } else {
+        Image binary_image;
+        if (!ThresholdImage(input_image, std::stoi(method), &binary_image)) {
+            std::cerr << "Error creating binary image\n";
+            return 1;
+        }
 
-    int x_center, y_center;
-    double radius;
-    FindSphereCenterAndRadius(binary_image, x_center, y_center, radius);
+        int x_center_pixel, y_center_pixel;
+        FindSphereCenterAndRadius(binary_image, x_center_pixel, y_center_pixel, radius);
+        x_center = x_center_pixel;
+        y_center = y_center_pixel;
+    }
 
     std::ofstream output_file(output_filename);
     if (!output_file) {
@@ -3,93 +3,57 @@ Name: Kevin Fang
 File: s2.cc
 Description:
     The program, s2.cc, is supposed to computes the directions and intensities of light sources in
-    three images of a sphere. Using the sphere's center and radius obtained from 
-    s1.cc, it calculates the normal vector to the sphere's surface at the 
-    brightest point in each image, which represents the direction of the light source. 
-    The brightness of the brightest pixel in each image is used to scale the normal 
-    vector, indicating the light source intensity.
+    three (or more) images of a sphere. Using the sphere's center and radius obtained from 
+    s1.cc, each pixel on the sphere's disc has a known normal vector, and the light direction is
+    the vector that best explains the disc's brightness as normal . direction (a least-squares
+    Lambertian fit, leaving out the shadowed pixels and the blurred rim). Fitting the whole disc
+    instead of taking its brightest pixel keeps a noise spike or hot pixel from moving the light.
+    The length of the vector is the brightness of a pixel facing the light, indicating the light
+    source intensity. Only the disc is scanned, and the images are processed concurrently.
 
     For each image, the program outputs a direction vector with x-, y-, and z-components 
     scaled by brightness, representing the light source direction and intensity.
+    Any number of sphere images can be given; the output has one line per image, in order,
+    which s3 reads as its light directions.
 
 To run this program after compiling:
-    ./s2 <input parameters filename> <input sphere image 1 filename> <input sphere image 2 filename> <input sphere image 3 filename> <output directions filename>
+    ./s2 <input parameters filename> <input sphere image 1 filename> ... <input sphere image N filename> <output directions filename>
     Ex: ./s2 parameters.txt sphere1.pgm sphere2.pgm sphere3.pgm directions.txt
 */
 #include "image.h"
+#include "calibration.h"
 #include <iostream>
 #include <fstream>
-#include <cmath>
 #include <vector>
 #include <string>
 
 using namespace ComputerVisionProjects;
 
-// To compute the normal vector at a point (x, y) on the sphere's surface
-void ComputeNormal(int x, int y, int x_center, int y_center, double radius, double &nx, double &ny, double &nz) {
-    nx = (x - x_center) / radius;
-    ny = (y - y_center) / radius;
-    nz = std::sqrt(1.0 - nx * nx - ny * ny);
-}
-
-// To find the brightest pixel's coordinates and brightness in an image
-void FindBrightestPixel(const Image &image, int &x, int &y, int &brightness) {
-    brightness = -1;
-    for (size_t i = 0; i < image.num_rows(); ++i) {
-        for (size_t j = 0; j < image.num_columns(); ++j) {
-            int pixel_value = image.GetPixel(i, j);
-            if (pixel_value > brightness) {
-                brightness = pixel_value;
-                x = j;
-                y = i;
-            }
-        }
-    }
-}
-
 int main(int argc, char *argv[]) {
-    if (argc != 6) {
-        std::cerr << "Usage: " << argv[0] << " {input parameters filename} {input sphere image 1 filename} {input sphere image 2 filename} {input sphere image 3 filename} {output directions filename}\n";
+    if (argc < 4) {
+        std::cerr << "Usage: " << argv[0] << " {input parameters filename} {input sphere image 1 filename} ... {input sphere image N filename} {output directions filename}\n";
         return 1;
     }
 
     const std::string parameters_filename(argv[1]);
-    const std::string image_filename1(argv[2]);
-    const std::string image_filename2(argv[3]);
-    const std::string image_filename3(argv[4]);
-    const std::string output_filename(argv[5]);
+    const std::string output_filename(argv[argc - 1]);
 
-    // This part reads sphere center and radius from parameters file
-    int x_center, y_center;
-    double radius;
+    // This part reads sphere center and radius from parameters file (the center may be sub-pixel)
+    Sphere sphere;
     std::ifstream param_file(parameters_filename);
-    if (!param_file || !(param_file >> x_center >> y_center >> radius)) {
+    if (!param_file || !(param_file >> sphere.x_center >> sphere.y_center >> sphere.radius)) {
         std::cerr << "Error reading parameters file.\n";
         return 1;
     }
     param_file.close();
 
-    std::vector<std::string> image_filenames = {image_filename1, image_filename2, image_filename3};
-    std::vector<std::vector<double>> light_directions;
-
-    for (const auto &filename : image_filenames) {
-        Image image;
-        if (!ReadImage(filename, &image)) {
-            std::cerr << "Error reading image: " << filename << "\n";
-            return 1;
-        }
-
-        int x, y, brightness;
-        FindBrightestPixel(image, x, y, brightness);
-
-        double nx, ny, nz;
-        ComputeNormal(x, y, x_center, y_center, radius, nx, ny, nz);
-
-        nx *= brightness;
-        ny *= brightness;
-        nz *= brightness;
-
-        light_directions.push_back({nx, ny, nz});
+    // Lambertian fit over the sphere's disc in every image, the images measured concurrently
+    // (calibration.cc)
+    const std::vector<std::string> image_filenames(argv + 2, argv + argc - 1);
+    std::vector<LightDirection> light_directions;
+    if (!MeasureLightDirections(image_filenames, sphere, &light_directions)) {
+        std::cerr << "Error measuring light directions.\n";
+        return 1;
     }
 
     // For error encounters and messages within terminal
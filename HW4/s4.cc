@@ -0,0 +1,101 @@
+/*
+Name: Kevin Fang
+File: s4.cc
+Description:
+    The program, s4.cc, is supposed to compute the depth (height) map of an object's surface from
+    the normal map computed by s3.cc (written as a .pfm file).
+    The surface gradients p = -nx/nz and q = -ny/nz are integrated with the Frankot-Chellappa
+    method (surface_integration.cc): the integrable surface closest to the gradients in the
+    least-squares sense, solved in the Fourier domain with a radix-2 FFT (fft.cc) that runs on
+    several threads. Pixels where the normal is missing or nearly vertical (nz below 0.05) are
+    left out of the integration and get depth 0, as does the background.
+
+    If the output filename ends in .pfm the depth is written as a PFM float image; otherwise it
+    is scaled to 0..255 (the lowest integrated point is 1, the highest 255, left out pixels 0).
+
+To run this program after compiling:
+    ./s4 <input normals filename (.pfm)> <output depth filename (.pfm or .pgm)> [<threads>]
+    Ex: ./s3 directions.txt object1.pgm object2.pgm object3.pgm 10 80 normals.pfm albedo.pfm
+        ./s4 normals.pfm depth.pgm
+*/
+#include "float_image.h"
+#include "image.h"
+#include "surface_integration.h"
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+using namespace ComputerVisionProjects;
+
+// Writes the depth of the integrated pixels scaled to 1..255, with 0 for the rest
+bool WriteDepthImage(const std::string &filename, const FloatImage &depth, const FloatImage &normals,
+                     double min_normal_z) {
+    double lowest = 0.0, highest = 0.0;
+    bool any = false;
+    for (size_t i = 0; i < depth.num_rows; ++i) {
+        for (size_t j = 0; j < depth.num_columns; ++j) {
+            if (normals.at(i, j, 2) < min_normal_z) continue;
+            const double z = depth.at(i, j, 0);
+            lowest = any ? std::min(lowest, z) : z;
+            highest = any ? std::max(highest, z) : z;
+            any = true;
+        }
+    }
+
+    Image output_depth;
+    output_depth.AllocateSpaceAndSetSize(depth.num_rows, depth.num_columns);
+    output_depth.SetNumberGrayLevels(255);
+    const double range = std::max(highest - lowest, 1e-9);
+    for (size_t i = 0; i < depth.num_rows; ++i) {
+        for (size_t j = 0; j < depth.num_columns; ++j) {
+            if (normals.at(i, j, 2) < min_normal_z) {
+                output_depth.SetPixel(i, j, 0);
+            } else {
+                output_depth.SetPixel(i, j, 1 + static_cast<int>(254.0 * (depth.at(i, j, 0) - lowest) / range));
+            }
+        }
+    }
+    return WriteImage(filename, output_depth);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 3 && argc != 4) {
+        std::cerr << "Usage: " << argv[0]
+                  << " {input normals filename (.pfm)} {output depth filename (.pfm or .pgm)} [{threads}]\n";
+        return 1;
+    }
+
+    const std::string normals_filename(argv[1]);
+    const std::string depth_filename(argv[2]);
+    IntegrationOptions options;
+    if (argc == 4) options.num_threads = std::stoi(argv[3]);
+
+    FloatImage normals;
+    if (!ReadPfm(normals_filename, &normals)) {
+        std::cerr << "Error reading normals file.\n";
+        return 1;
+    }
+    if (normals.num_channels != 3) {
+        std::cerr << "The normals file must have 3 channels (as written by s3).\n";
+        return 1;
+    }
+
+    FloatImage depth;
+    const int count = IntegrateNormals(normals, options, &depth);
+    if (count == 0) {
+        std::cerr << "No usable normals to integrate.\n";
+        return 1;
+    }
+
+    // For error encounters and messages within terminal
+    const bool written = IsPfmFilename(depth_filename)
+        ? WritePfm(depth_filename, depth)
+        : WriteDepthImage(depth_filename, depth, normals, options.min_normal_z);
+    if (!written) {
+        std::cerr << "Error writing depth image.\n";
+        return 1;
+    }
+
+    std::cout << "Depth of " << count << " pixels written to " << depth_filename << "\n";
+    return 0;
+}
@@ -0,0 +1,300 @@
+/*
+Name: Kevin Fang
+File: s5.cc
+Description:
+    The program, s5.cc, runs photometric stereo on many objects with one light calibration.
+
+    "calibrate" does the work of s1 and s2 once: it locates the sphere (with the Euclidean
+    distance transform of the pixels at or above a threshold, with a least-squares circle fit to
+    their boundary as "fit:<threshold>", adding ":ransac" to leave stray points out as s1's
+    "fit ransac" does, or with the circle Hough transform), measures the light direction in
+    every sphere image, and writes the sphere, the directions and the pseudo-inverse of the
+    light matrix into one calibration file (calibration.cc).
+
+    "batch" loads that calibration and solves every object set listed in a jobs file. Each line
+    of the jobs file holds the N object images (one per light, in calibration order) followed by
+    the normals and albedo output filenames (.pfm names get float images, as in s3). Lines that
+    are empty or start with # are skipped.
+    The object sets stream through a three-stage pipeline: one thread reads the images, one
+    solves the normals (photometric_stereo.cc) and one writes the outputs, so reading, solving and
+    writing of consecutive sets overlap. A small pool of buffers (planes and float maps) cycles
+    through the stages and is reused from set to set instead of being allocated per set.
+
+To run this program after compiling:
+    ./s5 calibrate <sphere image> <threshold | fit:threshold[:ransac] | hough> <sphere image 1> ... <sphere image N> <output calibration filename>
+    ./s5 batch <calibration filename> <jobs filename> <step> <threshold>
+    Ex: ./s5 calibrate sphere0.pgm 100 sphere1.pgm sphere2.pgm sphere3.pgm calibration.txt
+        ./s5 calibrate sphere0.pgm fit:100 sphere1.pgm sphere2.pgm sphere3.pgm calibration.txt
+        ./s5 batch calibration.txt jobs.txt 10 80
+    with jobs.txt holding lines like
+        object1.pgm object2.pgm object3.pgm normals_output.pgm albedo_output.pgm
+*/
+#include "image.h"
+#include "calibration.h"
+#include "photometric_stereo.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ComputerVisionProjects;
+
+// One object set: its filenames and the buffers it uses on its way through the pipeline
+struct Job {
+    std::vector<std::string> image_filenames;
+    std::string normals_filename;
+    std::string albedo_filename;
+};
+
+struct Slot {
+    const Job *job = nullptr;
+    bool ok = false;
+    Image first_image;  // Background of the needle image
+    std::vector<std::vector<unsigned char>> planes;
+    SurfaceMaps maps;
+};
+
+// Queue of slots between two pipeline stages; nullptr marks the end of the stream
+class SlotQueue {
+public:
+    void Push(Slot *slot) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            slots_.push_back(slot);
+        }
+        ready_.notify_one();
+    }
+
+    Slot *Pop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ready_.wait(lock, [this] { return !slots_.empty(); });
+        Slot *slot = slots_.front();
+        slots_.pop_front();
+        return slot;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<Slot *> slots_;
+};
+
+// Reads the jobs file; every line has num_lights images and two outputs
+bool ReadJobs(const std::string &filename, int num_lights, std::vector<Job> &jobs) {
+    std::ifstream input(filename);
+    if (!input) {
+        std::cerr << "Error reading jobs file.\n";
+        return false;
+    }
+    std::string line;
+    for (int line_number = 1; std::getline(input, line); ++line_number) {
+        std::istringstream words(line);
+        std::vector<std::string> names;
+        std::string name;
+        while (words >> name) names.push_back(name);
+        if (names.empty() || names[0][0] == '#') continue;
+        if (static_cast<int>(names.size()) != num_lights + 2) {
+            std::cerr << "Jobs file line " << line_number << ": expected " << num_lights
+                      << " images and 2 outputs.\n";
+            return false;
+        }
+        Job job;
+        job.image_filenames.assign(names.begin(), names.begin() + num_lights);
+        job.normals_filename = names[num_lights];
+        job.albedo_filename = names[num_lights + 1];
+        jobs.push_back(job);
+    }
+    return true;
+}
+
+// Reads the images of slot->job into its planes
+bool ReadSlotImages(Slot *slot) {
+    const Job &job = *slot->job;
+    slot->planes.resize(job.image_filenames.size());
+    for (size_t k = 0; k < job.image_filenames.size(); ++k) {
+        Image image;
+        Image &target = (k == 0) ? slot->first_image : image;
+        if (!ReadImage(job.image_filenames[k], &target)) return false;
+        if (target.num_rows() != slot->first_image.num_rows() ||
+            target.num_columns() != slot->first_image.num_columns()) {
+            std::cerr << "Images of different sizes in set " << job.image_filenames[0] << "\n";
+            return false;
+        }
+        ImageToPlane(target, &slot->planes[k]);
+    }
+    return true;
+}
+
+// Parses the sphere locator of calibrate: "hough", "<threshold>" (distance transform) or
+// "fit:<threshold>[:ransac]" (least-squares circle fit, as s1 with "fit [ransac]").
+bool ParseLocator(const std::string &text, std::string &locator, int &threshold, bool &ransac) {
+    threshold = 0;
+    ransac = false;
+    if (text == "hough") {
+        locator = "hough";
+        return true;
+    }
+    std::istringstream fields(text);
+    locator = "edt";
+    if (text.compare(0, 4, "fit:") == 0) {
+        locator = "fit";
+        fields.ignore(4);
+    }
+    if (!(fields >> threshold)) return false;
+    std::string rest;
+    std::getline(fields, rest);
+    if (locator == "fit" && rest == ":ransac") ransac = true;
+    else if (!rest.empty()) return false;
+    return true;
+}
+
+int Calibrate(int argc, char *argv[]) {
+    // s5 calibrate <sphere image> <threshold | fit:threshold[:ransac] | hough> <sphere images ...> <output>
+    if (argc < 7) {
+        std::cerr << "calibrate needs a sphere image, a threshold (or fit:threshold or hough), at "
+                     "least three sphere images and an output filename.\n";
+        return 1;
+    }
+    std::string locator;
+    int threshold;
+    bool ransac;
+    if (!ParseLocator(argv[3], locator, threshold, ransac)) {
+        std::cerr << "Bad sphere locator " << argv[3]
+                  << ": expected <threshold>, fit:<threshold>[:ransac] or hough.\n";
+        return 1;
+    }
+    const std::string output_filename(argv[argc - 1]);
+
+    Image sphere_image;
+    if (!ReadImage(argv[2], &sphere_image)) {
+        std::cerr << "Error reading sphere image.\n";
+        return 1;
+    }
+    Calibration calibration;
+    bool located;
+    if (locator == "hough") {
+        located = LocateSphereByHough(sphere_image, &calibration.sphere);
+    } else if (locator == "fit") {
+        located = LocateSphereByFit(sphere_image, threshold, ransac, &calibration.sphere);
+    } else {
+        located = LocateSphereByDistance(sphere_image, threshold, &calibration.sphere);
+    }
+    if (!located) {
+        std::cerr << "Error: no sphere found in " << argv[2] << "\n";
+        return 1;
+    }
+
+    const std::vector<std::string> image_filenames(argv + 4, argv + argc - 1);
+    if (!MeasureLightDirections(image_filenames, calibration.sphere, &calibration.directions)) {
+        std::cerr << "Error measuring light directions.\n";
+        return 1;
+    }
+
+    LightSet lights;
+    if (!lights.Set(calibration.directions)) {
+        std::cerr << "Light directions don't span 3-D, cannot invert.\n";
+        return 1;
+    }
+    if (!WriteCalibration(output_filename, calibration, lights)) {
+        std::cerr << "Error writing calibration file.\n";
+        return 1;
+    }
+    std::cout << "Sphere (" << calibration.sphere.x_center << ", " << calibration.sphere.y_center
+              << ") radius " << calibration.sphere.radius << " and " << lights.num_lights()
+              << " lights written to " << output_filename << "\n";
+    return 0;
+}
+
+int Batch(int argc, char *argv[]) {
+    // s5 batch <calibration> <jobs> <step> <threshold>
+    if (argc != 6) {
+        std::cerr << "batch needs a calibration file, a jobs file, a step and a threshold.\n";
+        return 1;
+    }
+    const int step = std::stoi(argv[4]);
+    const int threshold = std::stoi(argv[5]);
+    if (step <= 0) {
+        std::cerr << "Step must be greater than 0.\n";
+        return 1;
+    }
+
+    Calibration calibration;
+    LightSet lights;
+    if (!ReadCalibration(argv[2], &calibration, &lights)) {
+        std::cerr << "Error reading calibration file.\n";
+        return 1;
+    }
+    std::vector<Job> jobs;
+    if (!ReadJobs(argv[3], lights.num_lights(), jobs)) return 1;
+
+    // Enough slots for every stage to have one in hand and one waiting
+    const int kNumSlots = 4;
+    std::vector<std::unique_ptr<Slot>> slots;
+    SlotQueue free_slots, to_solve, to_write;
+    for (int k = 0; k < kNumSlots; ++k) {
+        slots.emplace_back(new Slot);
+        free_slots.Push(slots.back().get());
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    std::thread reader([&] {
+        for (const Job &job : jobs) {
+            Slot *slot = free_slots.Pop();
+            slot->job = &job;
+            slot->ok = ReadSlotImages(slot);
+            to_solve.Push(slot);
+        }
+        to_solve.Push(nullptr);
+    });
+    std::thread solver([&] {
+        while (Slot *slot = to_solve.Pop()) {
+            if (slot->ok) {
+                ComputeSurfaceMaps(slot->planes, lights, slot->first_image.num_rows(),
+                                   slot->first_image.num_columns(), threshold, &slot->maps);
+            }
+            to_write.Push(slot);
+        }
+        to_write.Push(nullptr);
+    });
+
+    // The writer is this thread
+    int num_written = 0, num_failed = 0;
+    while (Slot *slot = to_write.Pop()) {
+        if (slot->ok && WriteSurfaceMaps(slot->job->normals_filename, slot->job->albedo_filename,
+                                         slot->maps, slot->first_image, step)) {
+            ++num_written;
+        } else {
+            std::cerr << "Object set " << slot->job->image_filenames[0] << " failed.\n";
+            ++num_failed;
+        }
+        free_slots.Push(slot);
+    }
+    reader.join();
+    solver.join();
+    const double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << num_written << " object sets solved in " << seconds << " s ("
+              << (seconds > 0 ? num_written / seconds : 0.0) << " sets/s)";
+    if (num_failed > 0) std::cout << ", " << num_failed << " failed";
+    std::cout << "\n";
+    return num_failed > 0 ? 1 : 0;
+}
+
+int main(int argc, char *argv[]) {
+    const std::string mode = (argc > 1) ? argv[1] : "";
+    if (mode == "calibrate") return Calibrate(argc, argv);
+    if (mode == "batch") return Batch(argc, argv);
+    std::cerr << "Usage: " << argv[0]
+              << " calibrate {sphere image} {threshold | fit:threshold[:ransac] | hough} {sphere image 1} ... {sphere image N} {output calibration filename}\n"
+              << "       " << argv[0]
+              << " batch {calibration filename} {jobs filename} {step} {threshold}\n";
+    return 1;
+}
@@ -0,0 +1,103 @@
+/*
+Name: Kevin Fang
+File: sphere_check.cc
+Description:
+    The program, sphere_check.cc, checks the circle Hough sphere locator of calibration.cc
+    (s1.cc with "hough") against synthetic images whose center and radius are known. Each
+    image is a sphere at a sub-pixel position on a dark background, drawn as a flat disc or
+    with Lambertian shading under a light from the front or from the side (so that one side
+    fades into the background), with 4x4 supersampled edges and some noise. The center and
+    radius errors are printed for every image, and the program fails if any center is off
+    by more than the given tolerance.
+
+To run this program after compiling with the makefile (make sphere_check):
+    ./sphere_check [<center tolerance in pixels>]
+    Ex: ./sphere_check 0.5
+*/
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include "image.h"
+#include "calibration.h"
+
+using namespace std;
+using namespace ComputerVisionProjects;
+
+struct Shading {
+    const char *name;
+    // Light direction (x right, y up, z toward the camera); a zero
+    // direction draws a flat disc.
+    double x, y, z;
+};
+
+// Draws a sphere of the given center and radius into a 480 x 640 image:
+// background 5, a flat disc 200, or 20 + 235 max(0, n.s) when shaded,
+// plus uniform noise of +-3 gray levels.
+void DrawSphere(double x_center, double y_center, double radius, const Shading &shading,
+                unsigned int seed, Image *an_image) {
+    an_image->AllocateSpaceAndSetSize(480, 640);
+    an_image->SetNumberGrayLevels(255);
+    const double length = sqrt(shading.x * shading.x + shading.y * shading.y + shading.z * shading.z);
+    mt19937 generator(seed);
+    uniform_int_distribution<int> noise(-3, 3);
+    for (int i = 0; i < 480; ++i) {
+        for (int j = 0; j < 640; ++j) {
+            double sum = 0;
+            for (int k = 0; k < 16; ++k) {
+                const double x = (j - 0.375 + 0.25 * (k % 4) - x_center) / radius;
+                const double y = (i - 0.375 + 0.25 * (k / 4) - y_center) / radius;
+                const double squared = x * x + y * y;
+                if (squared >= 1) {
+                    sum += 5;
+                } else if (length == 0) {
+                    sum += 200;
+                } else {
+                    const double dot = (x * shading.x - y * shading.y + sqrt(1 - squared) * shading.z) / length;
+                    sum += 20 + 235 * max(0.0, dot);
+                }
+            }
+            const int value = static_cast<int>(sum / 16 + 0.5) + noise(generator);
+            an_image->SetPixel(i, j, min(255, max(0, value)));
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 2) {
+        cerr << "Usage: " << argv[0] << " [<center tolerance in pixels>]" << endl;
+        return 1;
+    }
+    const double tolerance = (argc == 2) ? stod(argv[1]) : 0.5;
+
+    const Shading shadings[] = {
+        {"flat", 0, 0, 0},
+        {"front", 0, 0, 1},
+        {"upper right", 0.5, 0.5, 0.7},
+        {"left", -0.6, 0.2, 0.6},
+        {"grazing", 0.9, 0, 0.3},
+    };
+
+    double worst = 0;
+    for (int k = 0; k < 8; ++k) {
+        const double x_center = 300 + 4.37 * k;
+        const double y_center = 230 + 0.53 * k;
+        const double radius = 60 + 3.17 * k;
+        for (const Shading &shading : shadings) {
+            Image sphere_image;
+            DrawSphere(x_center, y_center, radius, shading, k + 1, &sphere_image);
+            Sphere sphere;
+            if (!LocateSphereByHough(sphere_image, &sphere)) {
+                cout << shading.name << " sphere " << k << ": not found" << endl;
+                return 1;
+            }
+            const double error = hypot(sphere.x_center - x_center, sphere.y_center - y_center);
+            worst = max(worst, error);
+            cout << shading.name << " sphere " << k << ": center off by " << error
+                 << ", radius off by " << sphere.radius - radius << endl;
+        }
+    }
+    cout << "Largest center error: " << worst << " (tolerance " << tolerance << ")" << endl;
+    return worst <= tolerance ? 0 : 1;
+}
@@ -0,0 +1,109 @@
+// Name: Kevin Fang
+// Surface integration: the depth map of a surface from its normal map,
+// with the Frankot-Chellappa method (the least-squares integrable
+// surface, solved in the Fourier domain).
+
+#include "surface_integration.h"
+
+#include <cmath>
+#include <complex>
+#include <vector>
+
+#include "fft.h"
+
+using namespace std;
+
+namespace ComputerVisionProjects {
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+
+// Angular frequency of index k of an n-point transform.
+double Frequency(size_t k, size_t n) {
+  const double wrapped = (k < (n + 1) / 2) ? static_cast<double>(k) : static_cast<double>(k) - n;
+  return 2.0 * kPi * wrapped / n;
+}
+
+}  // namespace
+
+int IntegrateNormals(const FloatImage &normals, const IntegrationOptions &options,
+                     FloatImage *depth) {
+  if (depth == nullptr || normals.num_channels != 3) abort();
+  const size_t rows = normals.num_rows;
+  const size_t cols = normals.num_columns;
+  depth->AllocateSpaceAndSetSize(rows, cols, 1);
+  if (rows == 0 || cols == 0) return 0;
+  const size_t padded_rows = NextPowerOfTwo(rows);
+  const size_t padded_cols = NextPowerOfTwo(cols);
+
+  // p + i q, with zero gradients outside the mask and in the padding.
+  vector<complex<double>> field(padded_rows * padded_cols, 0.0);
+  int count = 0;
+  for (size_t i = 0; i < rows; ++i) {
+    for (size_t j = 0; j < cols; ++j) {
+      const double nz = normals.at(i, j, 2);
+      if (!(nz >= options.min_normal_z)) continue;
+      field[i * padded_cols + j] = complex<double>(-normals.at(i, j, 0) / nz,
+                                                   -normals.at(i, j, 1) / nz);
+      ++count;
+    }
+  }
+  if (count == 0) return 0;
+
+  Fft2d(&field, padded_rows, padded_cols, false, options.num_threads);
+
+  // With F the transform of p + i q and k' = -k, P(k) = (F(k) +
+  // conj F(k')) / 2 and Q(k) = (F(k) - conj F(k')) / 2i. The surface
+  // closest to the gradients has Z(k) = -i (wx P + wy Q) / (wx^2 + wy^2),
+  // and Z(k') = conj Z(k) because the depth is real, so each pair of
+  // frequencies is solved together in place.
+  for (size_t u = 0; u < padded_rows; ++u) {
+    const size_t mirror_u = (padded_rows - u) % padded_rows;
+    const double wy = Frequency(u, padded_rows);
+    for (size_t v = 0; v < padded_cols; ++v) {
+      const size_t mirror_v = (padded_cols - v) % padded_cols;
+      const size_t k = u * padded_cols + v;
+      const size_t mirror = mirror_u * padded_cols + mirror_v;
+      if (mirror < k) continue;  // Solved with its mirror.
+      if (mirror == k) {
+        // DC (the unknown constant) and Nyquist frequencies.
+        field[k] = 0.0;
+        continue;
+      }
+      const double wx = Frequency(v, padded_cols);
+      const complex<double> f = field[k];
+      const complex<double> f_mirror = conj(field[mirror]);
+      const complex<double> p = (f + f_mirror) * 0.5;
+      const complex<double> q = (f - f_mirror) * complex<double>(0.0, -0.5);
+      const complex<double> z = complex<double>(0.0, -1.0) * (wx * p + wy * q) / (wx * wx + wy * wy);
+      field[k] = z;
+      field[mirror] = conj(z);
+    }
+  }
+
+  Fft2d(&field, padded_rows, padded_cols, true, options.num_threads);
+
+  // Shift so the pixels left out average 0.
+  double sum_in = 0, sum_out = 0;
+  for (size_t i = 0; i < rows; ++i) {
+    for (size_t j = 0; j < cols; ++j) {
+      const double z = field[i * padded_cols + j].real();
+      if (normals.at(i, j, 2) >= options.min_normal_z)
+        sum_in += z;
+      else
+        sum_out += z;
+    }
+  }
+  const size_t num_out = rows * cols - count;
+  const double offset = (num_out > 0) ? sum_out / num_out : sum_in / count;
+  for (size_t i = 0; i < rows; ++i) {
+    for (size_t j = 0; j < cols; ++j) {
+      if (normals.at(i, j, 2) >= options.min_normal_z)
+        depth->at(i, j, 0) = field[i * padded_cols + j].real() - offset;
+    }
+  }
+  return count;
+}
+
+}  // namespace ComputerVisionProjects
@@ -0,0 +1,37 @@
+// Name: Kevin Fang
+// Surface integration: the depth map of a surface from its normal map,
+// with the Frankot-Chellappa method (the least-squares integrable
+// surface, solved in the Fourier domain).
+
+#ifndef COMPUTER_VISION_SURFACE_INTEGRATION_H_
+#define COMPUTER_VISION_SURFACE_INTEGRATION_H_
+
+#include "float_image.h"
+
+namespace ComputerVisionProjects {
+
+struct IntegrationOptions {
+  // Pixels whose unit normal has a z component below this (unsolved
+  // pixels have 0) are left out: their gradients are taken as 0, which
+  // also keeps near-vertical normals from producing huge slopes.
+  double min_normal_z = 0.05;
+  // 0 means one thread per hardware thread.
+  int num_threads = 0;
+};
+
+// Integrates the gradients p = -nx / nz (along columns) and
+// q = -ny / nz (along rows) of normals (3-channel, as written by s3)
+// into depth (1-channel, same size, larger is closer to the camera).
+// The gradient field is padded to powers of two and transformed once as
+// the complex field p + i q, so the only large buffer is one complex
+// value per padded pixel; the 2-D FFTs run on options.num_threads
+// threads. Depth is defined up to a constant: it is shifted so that the
+// pixels left out average 0 (or the integrated ones, if none is left
+// out), and the pixels left out get 0.
+// Returns the number of pixels integrated.
+int IntegrateNormals(const FloatImage &normals, const IntegrationOptions &options,
+                     FloatImage *depth);
+
+}  // namespace ComputerVisionProjects
+
+#endif  // COMPUTER_VISION_SURFACE_INTEGRATION_H_
@@ -0,0 +1,374 @@
+// Name: Kevin Fang
+// Deconvolution of blurred images with a known point-spread function:
+// Wiener filtering and Richardson-Lucy iterations in the Fourier domain
+// (as skimage.restoration's wiener and richardson_lucy, used by
+// deblurring_methods.py), on gray levels scaled to [0, 1].
+
+#include "deconvolution.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+using namespace std;
+
+namespace ComputerVisionProjects {
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+
+// Blurred estimates at or below this are taken as 0 in the
+// Richardson-Lucy ratio instead of dividing by them.
+const double kRatioEpsilon = 1e-12;
+
+// Runs body(begin, end) over [0, count) split into num_threads
+// contiguous ranges, one thread each.
+template <typename Body>
+void ParallelFor(size_t count, int num_threads, Body body) {
+  if (num_threads <= 0) num_threads = max(1u, thread::hardware_concurrency());
+  num_threads = max<size_t>(1, min<size_t>(num_threads, count));
+  vector<thread> threads;
+  for (int t = 1; t < num_threads; ++t)
+    threads.emplace_back(body, count * t / num_threads, count * (t + 1) / num_threads);
+  body(0, count / num_threads);
+  for (thread &worker : threads) worker.join();
+}
+
+// Like ParallelFor, for sums: body(begin, end, sums) adds num_sums
+// values over its range into sums, which start at 0, and the ranges'
+// sums are added up in range order into totals (so the result doesn't
+// depend on which thread finishes first).
+template <typename Body>
+void ParallelSum(size_t count, int num_threads, int num_sums, double *totals, Body body) {
+  if (num_threads <= 0) num_threads = max(1u, thread::hardware_concurrency());
+  num_threads = max<size_t>(1, min<size_t>(num_threads, count));
+  vector<double> partial(static_cast<size_t>(num_threads) * num_sums, 0.0);
+  vector<thread> threads;
+  for (int t = 1; t < num_threads; ++t) {
+    threads.emplace_back(body, count * t / num_threads, count * (t + 1) / num_threads,
+                         partial.data() + t * num_sums);
+  }
+  body(0, count / num_threads, partial.data());
+  for (thread &worker : threads) worker.join();
+  for (int s = 0; s < num_sums; ++s) totals[s] = 0;
+  for (int t = 0; t < num_threads; ++t)
+    for (int s = 0; s < num_sums; ++s) totals[s] += partial[t * num_sums + s];
+}
+
+// Index k of a padded axis of padded_size mapped into [0, size): the
+// axis itself, then its mirror image (without repeating the edge, like
+// cv2.BORDER_REFLECT_101) from whichever end of the axis is nearer once
+// the padding wraps around to index 0.
+size_t MirrorIndex(size_t k, size_t size, size_t padded_size) {
+  if (k < size) return k;
+  const size_t past_end = k - (size - 1);
+  const size_t before_start = padded_size - k;
+  return (past_end <= before_start) ? (size - 1) - min(past_end, size - 1)
+                                    : min(before_start, size - 1);
+}
+
+// plane (num_rows x num_columns) mirrored into padded (the transform's
+// size).
+void MirrorPad(const vector<double> &plane, size_t num_rows, size_t num_columns,
+               const RealFft2d &transform, vector<double> *padded) {
+  const size_t padded_rows = transform.num_rows();
+  const size_t padded_columns = transform.num_columns();
+  padded->resize(padded_rows * padded_columns);
+  for (size_t i = 0; i < padded_rows; ++i) {
+    const double *row = plane.data() + MirrorIndex(i, num_rows, padded_rows) * num_columns;
+    double *padded_row = padded->data() + i * padded_columns;
+    copy(row, row + num_columns, padded_row);
+    for (size_t j = num_columns; j < padded_columns; ++j)
+      padded_row[j] = row[MirrorIndex(j, num_columns, padded_columns)];
+  }
+}
+
+// The num_rows x num_columns image back out of padded.
+void Crop(const vector<double> &padded, const RealFft2d &transform, size_t num_rows,
+          size_t num_columns, vector<double> *plane) {
+  plane->resize(num_rows * num_columns);
+  for (size_t i = 0; i < num_rows; ++i) {
+    const double *row = padded.data() + i * transform.num_columns();
+    copy(row, row + num_columns, plane->data() + i * num_columns);
+  }
+}
+
+// Half spectrum of the kernel with its center moved to index (0, 0).
+void KernelSpectrum(const Kernel &kernel, const RealFft2d &transform,
+                    vector<complex<double>> *spectrum) {
+  const size_t rows = transform.num_rows();
+  const size_t cols = transform.num_columns();
+  vector<double> wrapped(rows * cols, 0.0);
+  for (int r = 0; r < kernel.num_rows; ++r) {
+    for (int c = 0; c < kernel.num_columns; ++c) {
+      const size_t i = (static_cast<long>(rows) + r - kernel.num_rows / 2) % rows;
+      const size_t j = (static_cast<long>(cols) + c - kernel.num_columns / 2) % cols;
+      wrapped[i * cols + j] += kernel.weights[r * kernel.num_columns + c];
+    }
+  }
+  spectrum->resize(rows * transform.spectrum_columns());
+  transform.Forward(wrapped.data(), spectrum->data(), 1);
+}
+
+// Running sums of values[index(k - radius)] ... values[index(k + radius)]
+// along one axis of count values spaced stride apart, borders reflected.
+void BoxSums(const double *values, size_t count, size_t stride, int radius, double *sums) {
+  const auto reflect = [count](long k) {
+    if (count == 1) return 0L;
+    const long period = 2 * (static_cast<long>(count) - 1);
+    k %= period;
+    if (k < 0) k += period;
+    return (k < static_cast<long>(count)) ? k : period - k;
+  };
+  double sum = 0;
+  for (long k = -radius; k <= radius; ++k) sum += values[reflect(k) * stride];
+  for (size_t k = 0; k < count; ++k) {
+    sums[k] = sum;
+    sum += values[reflect(static_cast<long>(k) + radius + 1) * stride] -
+           values[reflect(static_cast<long>(k) - radius) * stride];
+  }
+}
+
+}  // namespace
+
+Kernel UniformKernel(int size) {
+  if (size <= 0 || size % 2 == 0) abort();
+  Kernel kernel;
+  kernel.num_rows = kernel.num_columns = size;
+  kernel.weights.assign(size * size, 1.0 / (size * size));
+  return kernel;
+}
+
+Kernel GaussianKernel(int size, double sigma) {
+  if (size <= 0 || size % 2 == 0) abort();
+  // cv2.getGaussianKernel's default for a sigma that isn't positive.
+  if (sigma <= 0) sigma = 0.3 * ((size - 1) * 0.5 - 1) + 0.8;
+  vector<double> profile(size);
+  double total = 0;
+  for (int k = 0; k < size; ++k) {
+    const double offset = k - (size - 1) / 2.0;
+    profile[k] = exp(-offset * offset / (2 * sigma * sigma));
+    total += profile[k];
+  }
+  Kernel kernel;
+  kernel.num_rows = kernel.num_columns = size;
+  kernel.weights.resize(size * size);
+  for (int r = 0; r < size; ++r)
+    for (int c = 0; c < size; ++c)
+      kernel.weights[r * size + c] = profile[r] * profile[c] / (total * total);
+  return kernel;
+}
+
+void ImageToUnitPlane(const Image &an_image, vector<double> *plane) {
+  if (plane == nullptr) abort();
+  const size_t rows = an_image.num_rows(), cols = an_image.num_columns();
+  plane->resize(rows * cols);
+  for (size_t i = 0; i < rows; ++i)
+    for (size_t j = 0; j < cols; ++j) (*plane)[i * cols + j] = an_image.GetPixel(i, j) / 255.0;
+}
+
+void UnitPlaneToImage(const vector<double> &plane, size_t num_rows, size_t num_columns,
+                      Image *an_image) {
+  if (an_image == nullptr || plane.size() != num_rows * num_columns) abort();
+  an_image->AllocateSpaceAndSetSize(num_rows, num_columns);
+  an_image->SetNumberGrayLevels(255);
+  for (size_t i = 0; i < num_rows; ++i) {
+    for (size_t j = 0; j < num_columns; ++j) {
+      const double value = min(1.0, max(0.0, plane[i * num_columns + j]));
+      an_image->SetPixel(i, j, static_cast<int>(value * 255));
+    }
+  }
+}
+
+double EstimateNoiseVariance(const vector<double> &plane, size_t num_rows, size_t num_columns,
+                             int box_size) {
+  if (box_size <= 0 || box_size % 2 == 0 || plane.size() != num_rows * num_columns) abort();
+  if (plane.empty()) return 0;
+  const int radius = box_size / 2;
+  // Box sums along the rows, then along the columns of those.
+  vector<double> row_sums(plane.size()), box_sums(plane.size());
+  for (size_t i = 0; i < num_rows; ++i)
+    BoxSums(&plane[i * num_columns], num_columns, 1, radius, &row_sums[i * num_columns]);
+  vector<double> column_sums(num_rows);
+  for (size_t j = 0; j < num_columns; ++j) {
+    BoxSums(&row_sums[j], num_rows, num_columns, radius, column_sums.data());
+    for (size_t i = 0; i < num_rows; ++i) box_sums[i * num_columns + j] = column_sums[i];
+  }
+
+  const double box_area = static_cast<double>(box_size) * box_size;
+  double sum = 0;
+  for (size_t k = 0; k < plane.size(); ++k) sum += plane[k] - box_sums[k] / box_area;
+  const double mean = sum / plane.size();
+  double squares = 0;
+  for (size_t k = 0; k < plane.size(); ++k) {
+    const double residual = plane[k] - box_sums[k] / box_area - mean;
+    squares += residual * residual;
+  }
+  return squares / plane.size();
+}
+
+double PeakSignalToNoiseRatio(const Image &original, const Image &processed) {
+  if (original.num_rows() != processed.num_rows() ||
+      original.num_columns() != processed.num_columns())
+    abort();
+  double squares = 0;
+  for (size_t i = 0; i < original.num_rows(); ++i) {
+    for (size_t j = 0; j < original.num_columns(); ++j) {
+      const double difference = original.GetPixel(i, j) - processed.GetPixel(i, j);
+      squares += difference * difference;
+    }
+  }
+  if (squares == 0) return numeric_limits<double>::infinity();
+  const double mean_square = squares / (original.num_rows() * original.num_columns());
+  return 10.0 * log10(255.0 * 255.0 / mean_square);
+}
+
+WienerDeconvolver::WienerDeconvolver(const Kernel &psf, size_t num_rows, size_t num_columns)
+    : num_rows_{num_rows},
+      num_columns_{num_columns},
+      transform_(NextPowerOfTwo(num_rows + psf.num_rows),
+                 NextPowerOfTwo(num_columns + psf.num_columns)) {
+  if (psf.num_rows % 2 == 0 || psf.num_columns % 2 == 0 ||
+      psf.weights.size() != static_cast<size_t>(psf.num_rows) * psf.num_columns)
+    abort();
+  KernelSpectrum(psf, transform_, &psf_spectrum_);
+
+  // The Laplacian [0 -1 0; -1 4 -1; 0 -1 0] has the real transfer
+  // function 4 - 2 cos(wy) - 2 cos(wx).
+  const size_t rows = transform_.num_rows();
+  const size_t width = transform_.spectrum_columns();
+  regularizer_power_.resize(rows * width);
+  for (size_t u = 0; u < rows; ++u) {
+    for (size_t v = 0; v < width; ++v) {
+      const double laplacian = 4.0 - 2.0 * cos(2.0 * kPi * u / rows) -
+                               2.0 * cos(2.0 * kPi * v / transform_.num_columns());
+      regularizer_power_[u * width + v] = laplacian * laplacian;
+    }
+  }
+}
+
+void WienerDeconvolver::Deconvolve(const vector<double> &blurred, double balance,
+                                   int num_threads, vector<double> *restored) const {
+  if (restored == nullptr || blurred.size() != num_rows_ * num_columns_) abort();
+  restored->resize(num_rows_ * num_columns_);
+  if (restored->empty()) return;
+  vector<double> padded;
+  MirrorPad(blurred, num_rows_, num_columns_, transform_, &padded);
+  vector<complex<double>> spectrum(psf_spectrum_.size());
+  transform_.Forward(padded.data(), spectrum.data(), num_threads);
+  for (size_t k = 0; k < spectrum.size(); ++k) {
+    const complex<double> h = psf_spectrum_[k];
+    const double denominator = norm(h) + balance * regularizer_power_[k];
+    spectrum[k] = (denominator > 0) ? spectrum[k] * conj(h) / denominator : 0.0;
+  }
+  transform_.Inverse(spectrum.data(), padded.data(), num_threads);
+  Crop(padded, transform_, num_rows_, num_columns_, restored);
+}
+
+RichardsonLucyDeconvolver::RichardsonLucyDeconvolver(const Kernel &psf, size_t num_rows,
+                                                     size_t num_columns)
+    : num_rows_{num_rows},
+      num_columns_{num_columns},
+      transform_(NextPowerOfTwo(num_rows + psf.num_rows),
+                 NextPowerOfTwo(num_columns + psf.num_columns)) {
+  if (psf.num_rows % 2 == 0 || psf.num_columns % 2 == 0 ||
+      psf.weights.size() != static_cast<size_t>(psf.num_rows) * psf.num_columns)
+    abort();
+  KernelSpectrum(psf, transform_, &psf_spectrum_);
+}
+
+void RichardsonLucyDeconvolver::Filter(vector<double> *values, bool mirrored, int num_threads) {
+  transform_.Forward(values->data(), spectrum_.data(), num_threads);
+  ParallelFor(spectrum_.size(), num_threads, [&](size_t begin, size_t end) {
+    for (size_t k = begin; k < end; ++k) {
+      const double a = spectrum_[k].real(), b = spectrum_[k].imag();
+      const double c = psf_spectrum_[k].real();
+      const double d = mirrored ? -psf_spectrum_[k].imag() : psf_spectrum_[k].imag();
+      spectrum_[k] = complex<double>(a * c - b * d, a * d + b * c);
+    }
+  });
+  transform_.Inverse(spectrum_.data(), values->data(), num_threads);
+}
+
+int RichardsonLucyDeconvolver::Deconvolve(const vector<double> &blurred,
+                                          const RichardsonLucyOptions &options,
+                                          vector<double> *restored) {
+  if (restored == nullptr || blurred.size() != num_rows_ * num_columns_) abort();
+  if (blurred.empty()) {
+    restored->clear();
+    return 0;
+  }
+  const int num_threads = options.num_threads;
+  const size_t size = transform_.num_rows() * transform_.num_columns();
+  // The buffers keep their memory from one call to the next.
+  MirrorPad(blurred, num_rows_, num_columns_, transform_, &observed_);
+  spectrum_.resize(psf_spectrum_.size());
+  // The blurred image is the first estimate (nonnegative, so every
+  // estimate stays nonnegative).
+  estimate_.resize(size);
+  for (size_t k = 0; k < size; ++k) estimate_[k] = max(0.0, observed_[k]);
+  previous_.assign(estimate_.begin(), estimate_.end());
+  step_.assign(size, 0.0);
+  previous_step_.assign(size, 0.0);
+  predicted_.resize(size);
+  ratio_.resize(size);
+
+  int iteration = 0;
+  while (iteration < options.max_iterations) {
+    // Biggs-Andrews: extrapolate along the last step, by how much the
+    // last two steps (each new estimate minus the point it came from)
+    // agree.
+    double acceleration = 0;
+    if (options.accelerate && iteration >= 2) {
+      double sums[2];  // along, length
+      ParallelSum(size, num_threads, 2, sums, [&](size_t begin, size_t end, double *partial) {
+        for (size_t k = begin; k < end; ++k) {
+          partial[0] += step_[k] * previous_step_[k];
+          partial[1] += previous_step_[k] * previous_step_[k];
+        }
+      });
+      if (sums[1] > 0) acceleration = min(1.0, max(0.0, sums[0] / sums[1]));
+    }
+    ParallelFor(size, num_threads, [&](size_t begin, size_t end) {
+      for (size_t k = begin; k < end; ++k) {
+        predicted_[k] = max(0.0, estimate_[k] + acceleration * (estimate_[k] - previous_[k]));
+        ratio_[k] = predicted_[k];
+      }
+    });
+
+    // New estimate = predicted * (mirrored PSF * (observed / (PSF *
+    // predicted))).
+    Filter(&ratio_, false, num_threads);
+    ParallelFor(size, num_threads, [&](size_t begin, size_t end) {
+      for (size_t k = begin; k < end; ++k) {
+        const double blurred_estimate = ratio_[k];
+        ratio_[k] = (blurred_estimate > kRatioEpsilon) ? observed_[k] / blurred_estimate : 0.0;
+      }
+    });
+    Filter(&ratio_, true, num_threads);
+
+    swap(previous_, estimate_);
+    swap(previous_step_, step_);
+    double sums[2];  // change, total
+    ParallelSum(size, num_threads, 2, sums, [&](size_t begin, size_t end, double *partial) {
+      for (size_t k = begin; k < end; ++k) {
+        estimate_[k] = predicted_[k] * max(0.0, ratio_[k]);
+        step_[k] = estimate_[k] - predicted_[k];
+        const double difference = estimate_[k] - previous_[k];
+        partial[0] += difference * difference;
+        partial[1] += estimate_[k] * estimate_[k];
+      }
+    });
+    ++iteration;
+    if (options.tolerance > 0 && iteration >= options.min_iterations &&
+        sums[0] <= options.tolerance * options.tolerance * sums[1]) {
+      break;
+    }
+  }
+  Crop(estimate_, transform_, num_rows_, num_columns_, restored);
+  return iteration;
+}
+
+}  // namespace ComputerVisionProjects
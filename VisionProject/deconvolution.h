@@ -0,0 +1,152 @@
+// Name: Kevin Fang
+// Deconvolution of blurred images with a known point-spread function:
+// Wiener filtering and Richardson-Lucy iterations in the Fourier domain
+// (as skimage.restoration's wiener and richardson_lucy, used by
+// deblurring_methods.py), on gray levels scaled to [0, 1].
+
+#ifndef COMPUTER_VISION_DECONVOLUTION_H_
+#define COMPUTER_VISION_DECONVOLUTION_H_
+
+#include <complex>
+#include <cstdlib>
+#include <vector>
+
+#include "fft.h"
+#include "image.h"
+
+namespace ComputerVisionProjects {
+
+// A point-spread function: num_rows x num_columns weights (row-major),
+// both odd, centered on the middle weight.
+struct Kernel {
+  int num_rows = 0;
+  int num_columns = 0;
+  std::vector<double> weights;
+};
+
+// size x size kernel of equal weights that sum to 1.
+Kernel UniformKernel(int size);
+
+// size x size Gaussian kernel that sums to 1: the outer product of
+// cv2.getGaussianKernel(size, sigma) with itself.
+Kernel GaussianKernel(int size, double sigma);
+
+// The gray levels of an_image divided by 255, row-major.
+void ImageToUnitPlane(const Image &an_image, std::vector<double> *plane);
+
+// Back from a plane of num_rows x num_columns values: clipped to [0, 1],
+// times 255 and truncated, as deblurring_methods.py converts to uint8.
+void UnitPlaneToImage(const std::vector<double> &plane, size_t num_rows, size_t num_columns,
+                      Image *an_image);
+
+// Noise variance of a plane, estimated as in apply_wiener_filter(): the
+// variance of the plane minus its box_size x box_size local mean
+// (borders reflected like cv2.filter2D). The local means are running
+// sums, so the cost doesn't depend on box_size.
+double EstimateNoiseVariance(const std::vector<double> &plane, size_t num_rows,
+                             size_t num_columns, int box_size);
+
+// Peak signal-to-noise ratio in dB of two images of the same size with
+// gray levels up to 255 (infinite if they are equal).
+double PeakSignalToNoiseRatio(const Image &original, const Image &processed);
+
+// Wiener deconvolution with a Laplacian regularizer, as skimage's
+// wiener(image, psf, balance):
+//   X = conj(H) Y / (|H|^2 + balance |L|^2)
+// with H the transfer function of the PSF and L that of the discrete
+// Laplacian. The image is mirrored into padding (to power-of-two sizes
+// at least one PSF larger), so the transform's wrap-around doesn't ring
+// at the image borders.
+// Sample usage:
+//   WienerDeconvolver wiener(UniformKernel(5), rows, cols);
+//   wiener.Deconvolve(blurred, balance, 0, &restored);
+class WienerDeconvolver {
+ public:
+  // Computes the transfer functions once for images of num_rows x
+  // num_columns; psf must have odd sizes.
+  WienerDeconvolver(const Kernel &psf, size_t num_rows, size_t num_columns);
+
+  // Deconvolves blurred (num_rows x num_columns, row-major) into
+  // restored, with the transforms split among num_threads threads (0
+  // means one per hardware thread).
+  void Deconvolve(const std::vector<double> &blurred, double balance, int num_threads,
+                  std::vector<double> *restored) const;
+
+ private:
+  size_t num_rows_;
+  size_t num_columns_;
+  RealFft2d transform_;
+  // Half spectra of the PSF and |L|^2, transform_.num_rows() x
+  // transform_.spectrum_columns().
+  std::vector<std::complex<double>> psf_spectrum_;
+  std::vector<double> regularizer_power_;
+};
+
+// The defaults run the 30 plain iterations of apply_lucy_richardson, so
+// the result has the PSNR of the Python version. Acceleration and early
+// stopping take fewer iterations but don't keep that PSNR on every
+// image (see deblur.cc).
+struct RichardsonLucyOptions {
+  // Upper bound on the iterations.
+  int max_iterations = 30;
+  // Biggs-Andrews acceleration: each iteration starts from the estimate
+  // extrapolated along the previous step, which typically reaches a
+  // given estimate in a half to a third of the plain iterations. How far it gets
+  // per iteration varies, so a fixed budget of accelerated iterations
+  // over-restores noisy images (amplifying the noise) or stops short on
+  // clean ones.
+  bool accelerate = false;
+  // Stops once an iteration changes the estimate by less than this
+  // fraction (root-mean-square change over root-mean-square value); 0
+  // turns the test off. The change shrinks only about as 1/iterations,
+  // and by how much depends on the image, so the test is not made
+  // before min_iterations.
+  double tolerance = 0;
+  int min_iterations = 10;
+  // Threads for the transforms and the per-pixel steps (0 means one per
+  // hardware thread).
+  int num_threads = 0;
+};
+
+// Richardson-Lucy deconvolution, the maximum-likelihood estimate under
+// Poisson noise:
+//   x <- x (P' * (y / (P * x)))
+// with P the PSF and P' its mirror image, both applied by multiplying
+// half spectra. The blurred image, mirrored into padding as for
+// WienerDeconvolver, is also the first estimate. The padded buffers are
+// members, allocated once and reused by every iteration and every call
+// with images of the same size, so Deconvolve() isn't const and one
+// deconvolver serves one thread at a time.
+class RichardsonLucyDeconvolver {
+ public:
+  // Computes the PSF's transfer function once for images of num_rows x
+  // num_columns; psf must have odd sizes.
+  RichardsonLucyDeconvolver(const Kernel &psf, size_t num_rows, size_t num_columns);
+
+  // Deconvolves blurred (num_rows x num_columns, row-major) into
+  // restored. Returns the number of iterations run.
+  int Deconvolve(const std::vector<double> &blurred, const RichardsonLucyOptions &options,
+                 std::vector<double> *restored);
+
+ private:
+  // values <- PSF * values, or the mirrored PSF's, in place.
+  void Filter(std::vector<double> *values, bool mirrored, int num_threads);
+
+  size_t num_rows_;
+  size_t num_columns_;
+  RealFft2d transform_;
+  std::vector<std::complex<double>> psf_spectrum_;
+  // Scratch buffers of the transform's size.
+  std::vector<std::complex<double>> spectrum_;
+  std::vector<double> observed_;
+  std::vector<double> estimate_;
+  std::vector<double> previous_;
+  std::vector<double> predicted_;
+  std::vector<double> ratio_;
+  std::vector<double> step_;
+  std::vector<double> previous_step_;
+};
+
+}  // namespace ComputerVisionProjects
+
+#endif  // COMPUTER_VISION_DECONVOLUTION_H_
@@ -0,0 +1,205 @@
+// Name: Kevin Fang
+// Radix-2 fast Fourier transforms of complex data, in 1-D and 2-D, and
+// 2-D transforms of real data that only compute half of the spectrum.
+// Sizes must be powers of two; pad with NextPowerOfTwo().
+
+#include "fft.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+using namespace std;
+
+namespace ComputerVisionProjects {
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+
+// Columns transformed together, so that each row of the block is read
+// from memory once per block instead of once per column.
+const size_t kColumnBlock = 16;
+
+// Runs body(begin, end) over [0, count) split into num_threads
+// contiguous ranges, one thread each.
+template <typename Body>
+void ParallelFor(size_t count, int num_threads, Body body) {
+  if (num_threads <= 0) num_threads = max(1u, thread::hardware_concurrency());
+  num_threads = max<size_t>(1, min<size_t>(num_threads, count));
+  vector<thread> threads;
+  for (int t = 1; t < num_threads; ++t)
+    threads.emplace_back(body, count * t / num_threads, count * (t + 1) / num_threads);
+  body(0, count / num_threads);
+  for (thread &worker : threads) worker.join();
+}
+
+// Transforms the columns first to first + width of values (num_rows x
+// row_length) in place through buffer (width x num_rows).
+void TransformColumnBlock(const FftPlan &column_plan, complex<double> *values, size_t num_rows,
+                          size_t row_length, size_t first, size_t width, bool inverse,
+                          complex<double> *buffer) {
+  for (size_t i = 0; i < num_rows; ++i)
+    for (size_t c = 0; c < width; ++c) buffer[c * num_rows + i] = values[i * row_length + first + c];
+  for (size_t c = 0; c < width; ++c) column_plan.Transform(&buffer[c * num_rows], inverse);
+  for (size_t i = 0; i < num_rows; ++i)
+    for (size_t c = 0; c < width; ++c) values[i * row_length + first + c] = buffer[c * num_rows + i];
+}
+
+}  // namespace
+
+size_t NextPowerOfTwo(size_t n) {
+  size_t power = 1;
+  while (power < n) power <<= 1;
+  return power;
+}
+
+FftPlan::FftPlan(size_t size) : size_{size} {
+  if (size == 0 || (size & (size - 1)) != 0) abort();
+  twiddles_.resize(size / 2);
+  for (size_t k = 0; k < size / 2; ++k)
+    twiddles_[k] = polar(1.0, -2.0 * kPi * k / size);
+  for (size_t i = 1, j = 0; i < size; ++i) {
+    // j is i with its bits reversed, advanced by a reversed increment.
+    size_t bit = size >> 1;
+    for (; j & bit; bit >>= 1) j ^= bit;
+    j ^= bit;
+    if (i < j) swaps_.emplace_back(i, j);
+  }
+}
+
+void FftPlan::Transform(complex<double> *data, bool inverse) const {
+  for (const pair<size_t, size_t> &indices : swaps_) swap(data[indices.first], data[indices.second]);
+  // Iterative Cooley-Tukey butterflies on blocks of length 2, 4, ...
+  for (size_t length = 2; length <= size_; length <<= 1) {
+    const size_t half = length / 2;
+    const size_t stride = size_ / length;
+    for (size_t start = 0; start < size_; start += length) {
+      for (size_t k = 0; k < half; ++k) {
+        const complex<double> twiddle =
+            inverse ? conj(twiddles_[k * stride]) : twiddles_[k * stride];
+        // Spelled out: complex<double>'s operator* goes through a
+        // library call to handle NaN and infinity.
+        const complex<double> value = data[start + k + half];
+        const complex<double> odd(value.real() * twiddle.real() - value.imag() * twiddle.imag(),
+                                  value.real() * twiddle.imag() + value.imag() * twiddle.real());
+        data[start + k + half] = data[start + k] - odd;
+        data[start + k] += odd;
+      }
+    }
+  }
+  if (inverse) {
+    const double scale = 1.0 / size_;
+    for (size_t k = 0; k < size_; ++k) data[k] *= scale;
+  }
+}
+
+void Fft2d(vector<complex<double>> *data, size_t num_rows, size_t num_columns, bool inverse,
+           int num_threads) {
+  if (data == nullptr || data->size() != num_rows * num_columns) abort();
+  if (data->empty()) return;
+  const FftPlan row_plan(num_columns);
+  const FftPlan column_plan(num_rows);
+  complex<double> *values = data->data();
+
+  ParallelFor(num_rows, num_threads, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) row_plan.Transform(values + i * num_columns, inverse);
+  });
+
+  // Columns in blocks: gather a block of columns into contiguous
+  // buffers, transform them and scatter them back.
+  const size_t num_blocks = (num_columns + kColumnBlock - 1) / kColumnBlock;
+  ParallelFor(num_blocks, num_threads, [&](size_t begin, size_t end) {
+    vector<complex<double>> buffer(kColumnBlock * num_rows);
+    for (size_t block = begin; block < end; ++block) {
+      const size_t first = block * kColumnBlock;
+      TransformColumnBlock(column_plan, values, num_rows, num_columns, first,
+                           min(kColumnBlock, num_columns - first), inverse, buffer.data());
+    }
+  });
+}
+
+RealFft2d::RealFft2d(size_t num_rows, size_t num_columns)
+    : num_rows_{num_rows},
+      num_columns_{num_columns},
+      row_plan_(num_columns),
+      column_plan_(num_rows) {
+  if (num_columns < 2) abort();
+}
+
+void RealFft2d::TransformColumns(complex<double> *spectrum, bool inverse, int num_threads) const {
+  const size_t width = spectrum_columns();
+  const size_t num_blocks = (width + kColumnBlock - 1) / kColumnBlock;
+  ParallelFor(num_blocks, num_threads, [&](size_t begin, size_t end) {
+    vector<complex<double>> buffer(kColumnBlock * num_rows_);
+    for (size_t block = begin; block < end; ++block) {
+      const size_t first = block * kColumnBlock;
+      TransformColumnBlock(column_plan_, spectrum, num_rows_, width, first,
+                           min(kColumnBlock, width - first), inverse, buffer.data());
+    }
+  });
+}
+
+void RealFft2d::Forward(const double *real, complex<double> *spectrum, int num_threads) const {
+  const size_t cols = num_columns_;
+  const size_t width = spectrum_columns();
+  // Rows a and b as z = a + i b; then A[k] = (Z[k] + conj Z[-k]) / 2 and
+  // B[k] = (Z[k] - conj Z[-k]) / 2i.
+  const size_t num_pairs = (num_rows_ + 1) / 2;
+  ParallelFor(num_pairs, num_threads, [&](size_t begin, size_t end) {
+    vector<complex<double>> row(cols);
+    for (size_t pair = begin; pair < end; ++pair) {
+      const size_t first = 2 * pair;
+      const bool has_second = first + 1 < num_rows_;
+      const double *a = real + first * cols;
+      const double *b = a + cols;
+      for (size_t n = 0; n < cols; ++n) row[n] = complex<double>(a[n], has_second ? b[n] : 0.0);
+      row_plan_.Transform(row.data(), false);
+      complex<double> *a_spectrum = spectrum + first * width;
+      complex<double> *b_spectrum = a_spectrum + width;
+      for (size_t k = 0; k < width; ++k) {
+        const complex<double> z = row[k];
+        const complex<double> z_mirror = conj(row[(cols - k) % cols]);
+        a_spectrum[k] = (z + z_mirror) * 0.5;
+        if (has_second) b_spectrum[k] = (z - z_mirror) * complex<double>(0.0, -0.5);
+      }
+    }
+  });
+  TransformColumns(spectrum, false, num_threads);
+}
+
+void RealFft2d::Inverse(complex<double> *spectrum, double *real, int num_threads) const {
+  TransformColumns(spectrum, true, num_threads);
+  const size_t cols = num_columns_;
+  const size_t width = spectrum_columns();
+  // Each row's spectrum is now that of a real row; rebuild the full
+  // spectrum of z = a + i b from the halves of A and B.
+  const size_t num_pairs = (num_rows_ + 1) / 2;
+  ParallelFor(num_pairs, num_threads, [&](size_t begin, size_t end) {
+    vector<complex<double>> row(cols);
+    for (size_t pair = begin; pair < end; ++pair) {
+      const size_t first = 2 * pair;
+      const bool has_second = first + 1 < num_rows_;
+      const complex<double> *a_spectrum = spectrum + first * width;
+      const complex<double> *b_spectrum = a_spectrum + width;
+      const complex<double> i_unit(0.0, 1.0);
+      for (size_t k = 0; k < cols; ++k) {
+        const bool mirrored = k >= width;
+        const size_t index = mirrored ? cols - k : k;
+        const complex<double> a_value = mirrored ? conj(a_spectrum[index]) : a_spectrum[index];
+        complex<double> b_value = 0.0;
+        if (has_second) b_value = mirrored ? conj(b_spectrum[index]) : b_spectrum[index];
+        row[k] = a_value + i_unit * b_value;
+      }
+      row_plan_.Transform(row.data(), true);
+      double *a = real + first * cols;
+      double *b = a + cols;
+      for (size_t n = 0; n < cols; ++n) {
+        a[n] = row[n].real();
+        if (has_second) b[n] = row[n].imag();
+      }
+    }
+  });
+}
+
+}  // namespace ComputerVisionProjects
@@ -0,0 +1,91 @@
+// Name: Kevin Fang
+// Radix-2 fast Fourier transforms of complex data, in 1-D and 2-D, and
+// 2-D transforms of real data that only compute half of the spectrum.
+// Sizes must be powers of two; pad with NextPowerOfTwo().
+
+#ifndef COMPUTER_VISION_FFT_H_
+#define COMPUTER_VISION_FFT_H_
+
+#include <complex>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+namespace ComputerVisionProjects {
+
+// Smallest power of two that is at least n (1 for n = 0).
+size_t NextPowerOfTwo(size_t n);
+
+// Twiddle factors and bit-reversal order for transforms of one size,
+// computed once and shared (Transform() is const, so one plan can be
+// used by several threads at the same time).
+// Sample usage:
+//   FftPlan plan(256);
+//   plan.Transform(values.data(), false);  // Forward.
+//   plan.Transform(values.data(), true);   // Back to values.
+class FftPlan {
+ public:
+  // size must be a power of two.
+  explicit FftPlan(size_t size);
+
+  size_t size() const { return size_; }
+
+  // In-place transform of size() values. The forward transform is
+  //   X[k] = sum_n x[n] exp(-2 pi i k n / size);
+  // the inverse one uses exp(+2 pi i k n / size) and divides by size,
+  // so it undoes the forward one.
+  void Transform(std::complex<double> *data, bool inverse) const;
+
+ private:
+  size_t size_;
+  // exp(-2 pi i k / size) for k < size / 2.
+  std::vector<std::complex<double>> twiddles_;
+  // Pairs (i, j), i < j, swapped by the bit-reversal permutation.
+  std::vector<std::pair<size_t, size_t>> swaps_;
+};
+
+// In-place 2-D transform of data (num_rows x num_columns, row-major,
+// both powers of two): every row, then every column. Rows and columns
+// are split among num_threads threads (0 means one per hardware
+// thread).
+void Fft2d(std::vector<std::complex<double>> *data, size_t num_rows, size_t num_columns,
+           bool inverse, int num_threads);
+
+// 2-D transforms between a real num_rows x num_columns array and the
+// num_rows x spectrum_columns() half of its spectrum (columns 0 to
+// num_columns / 2; the rest follows from F(u, v) = conj F(-u, -v)).
+// Two real rows are transformed as one complex row, and only the half
+// spectrum's columns are transformed, so a transform costs about half
+// of Fft2d() on the same size. Both sizes must be powers of two, and
+// num_columns at least 2. Forward() and Inverse() are const, so one
+// plan can serve several threads.
+class RealFft2d {
+ public:
+  RealFft2d(size_t num_rows, size_t num_columns);
+
+  size_t num_rows() const { return num_rows_; }
+  size_t num_columns() const { return num_columns_; }
+  size_t spectrum_columns() const { return num_columns_ / 2 + 1; }
+
+  // spectrum gets num_rows() x spectrum_columns() values (row-major) of
+  // the forward transform of real (num_rows() x num_columns()).
+  void Forward(const double *real, std::complex<double> *spectrum, int num_threads) const;
+
+  // Inverse of Forward(); spectrum is used as scratch space and is
+  // overwritten. The imaginary part of the result, zero up to rounding
+  // for the spectrum of a real array, is dropped.
+  void Inverse(std::complex<double> *spectrum, double *real, int num_threads) const;
+
+ private:
+  // Transforms the spectrum's columns in place.
+  void TransformColumns(std::complex<double> *spectrum, bool inverse, int num_threads) const;
+
+  size_t num_rows_;
+  size_t num_columns_;
+  FftPlan row_plan_;
+  FftPlan column_plan_;
+};
+
+}  // namespace ComputerVisionProjects
+
+#endif  // COMPUTER_VISION_FFT_H_